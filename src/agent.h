@@ -45,6 +45,11 @@ private:
   os_exception_mask_t m_exceptions{ os_exception_mask_t::none };
   epoch_t m_mark{ 0 };
 
+  /* The number of waves of this agent stopped with a memory violation stop
+     reason.  It is maintained by the waves, see
+     wave_t::update_memory_violation_count.  */
+  size_t m_memory_violation_wave_count{ 0 };
+
   std::vector<const watchpoint_t *> m_watchpoints;
   const architecture_t *const m_architecture;
   process_t &m_process;
@@ -82,6 +87,17 @@ public:
   void clear_exceptions (os_exception_mask_t exceptions);
   os_exception_mask_t exceptions () const { return m_exceptions; }
 
+  size_t memory_violation_wave_count () const
+  {
+    return m_memory_violation_wave_count;
+  }
+  void add_memory_violation_wave () { ++m_memory_violation_wave_count; }
+  void remove_memory_violation_wave ()
+  {
+    dbgapi_assert (m_memory_violation_wave_count != 0);
+    --m_memory_violation_wave_count;
+  }
+
   void insert_watchpoint (const watchpoint_t &watchpoint);
   void remove_watchpoint (const watchpoint_t &watchpoint);
   const watchpoint_t *get_watchpoint (os_watch_id_t os_watch_id) const
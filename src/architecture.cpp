@@ -397,6 +397,7 @@ protected:
   virtual cbranch_cond_t
   cbranch_condition_code (const instruction_t &instruction) const = 0;
 
+  virtual bool is_nop (const instruction_t &instruction) const = 0;
   virtual bool is_sethalt (const instruction_t &instruction) const = 0;
   virtual bool is_barrier (const instruction_t &instruction) const = 0;
   virtual bool is_sleep (const instruction_t &instruction) const = 0;
@@ -1042,7 +1043,8 @@ amdgcn_architecture_t::can_simulate (wave_t & /* wave  */,
                 .has_value ();
 
   return is_branch (instruction) || is_cbranch (instruction)
-         || is_cbranch_join (instruction) || is_endpgm (instruction);
+         || is_cbranch_join (instruction) || is_endpgm (instruction)
+         || is_nop (instruction);
 }
 
 bool
@@ -1087,6 +1089,11 @@ amdgcn_architecture_t::simulate_instruction (
     {
       /* Only the pc is modified.  */
     }
+  else if (is_nop (instruction))
+    {
+      /* The wait states inserted by s_nop are not needed as the wave's
+         pipeline was drained when its context was saved.  */
+    }
   else if (is_endpgm (instruction))
     {
       wave.terminate ();
@@ -2458,6 +2465,7 @@ public:
   cbranch_cond_t
   cbranch_condition_code (const instruction_t &instruction) const override;
 
+  bool is_nop (const instruction_t &instruction) const override;
   bool is_sethalt (const instruction_t &instruction) const override;
   bool is_barrier (const instruction_t &instruction) const override;
   bool is_sleep (const instruction_t &instruction) const override;
@@ -2941,6 +2949,13 @@ gfx9_architecture_t::is_trap (const instruction_t &instruction,
   return false;
 }
 
+bool
+gfx9_architecture_t::is_nop (const instruction_t &instruction) const
+{
+  /* s_nop: SOPP Opcode 0. See comment in ::is_endpgm.  */
+  return is_sopp_encoding<0> (instruction);
+}
+
 bool
 gfx9_architecture_t::is_sethalt (const instruction_t &instruction) const
 {
@@ -5262,6 +5277,7 @@ public:
   is_subvector_loop_begin (const instruction_t &instruction) const override;
   bool is_subvector_loop_end (const instruction_t &instruction) const override;
 
+  bool is_nop (const instruction_t &instruction) const override;
   bool is_sethalt (const instruction_t &instruction) const override;
   bool is_barrier (const instruction_t &instruction) const override;
   bool is_sleep (const instruction_t &instruction) const override;
@@ -5618,6 +5634,13 @@ gfx11_architecture_t::terminating_instruction () const
                               std::byte{ 0xBF } }));
 }
 
+bool
+gfx11_architecture_t::is_nop (const instruction_t &instruction) const
+{
+  /* s_nop: SOPP Opcode 0  */
+  return is_sopp_encoding<0> (instruction);
+}
+
 bool
 gfx11_architecture_t::is_sethalt (const instruction_t &instruction) const
 {
@@ -7277,13 +7300,26 @@ architecture_t::register_set () const
   return all_registers;
 }
 
-bool
-architecture_t::is_register_available (amdgpu_regnum_t regnum) const
+void
+architecture_t::initialize_register_infos ()
 {
-  for (auto &&register_class : range<register_class_t> ())
-    if (register_class.contains (regnum))
-      return true;
-  return false;
+  dbgapi_assert (m_register_infos.empty ());
+  m_register_infos.resize (static_cast<size_t> (amdgpu_regnum_t::last_regnum)
+                           + 1);
+
+  /* The register queries are virtual and build strings, so compute them
+     once for all the registers available in this architecture.  */
+  for (auto &&regnum : register_set ())
+    {
+      auto dwarf_register = amdgpu_regnum_to_dwarf_register (regnum);
+      if (dwarf_register)
+        m_dwarf_register_map.emplace (*dwarf_register, regnum);
+
+      m_register_infos[static_cast<size_t> (regnum)].emplace (
+        register_info_t{ register_name (regnum), register_type (regnum),
+                         register_size (regnum), register_properties (regnum),
+                         dwarf_register });
+    }
 }
 
 void
@@ -7334,6 +7370,7 @@ auto
 make_architecture (Args &&...args)
 {
   auto arch = std::make_unique<Architecture> (std::forward<Args> (args)...);
+  arch->initialize_register_infos ();
   return std::make_pair (arch->id (), std::move (arch));
 }
 
@@ -155,6 +155,29 @@ private:
              handle_object_set_t<register_class_t>>
     m_handle_object_sets{};
 
+public:
+  /* Description of a register, computed once when the architecture is
+     instantiated.  */
+  struct register_info_t
+  {
+    std::string name;
+    std::string type;
+    amd_dbgapi_size_t size;
+    amd_dbgapi_register_properties_t properties;
+    std::optional<uint64_t> dwarf_register;
+  };
+
+private:
+  /* The description of the registers in register_set (), indexed by regnum.
+     Registers not available in this architecture have no value.  */
+  std::vector<std::optional<register_info_t>> m_register_infos{};
+  std::unordered_map<uint64_t, amdgpu_regnum_t> m_dwarf_register_map{};
+
+  void initialize_register_infos ();
+
+  template <typename Architecture, typename... Args>
+  friend auto make_architecture (Args &&...args);
+
 protected:
   architecture_t (elf_amdgpu_machine_t e_machine, std::string target_triple);
 
@@ -417,7 +440,29 @@ public:
   register_properties (amdgpu_regnum_t regnum) const = 0;
 
   std::set<amdgpu_regnum_t> register_set () const;
-  bool is_register_available (amdgpu_regnum_t regnum) const;
+  bool is_register_available (amdgpu_regnum_t regnum) const
+  {
+    size_t index = static_cast<size_t> (regnum);
+    return index < m_register_infos.size ()
+           && m_register_infos[index].has_value ();
+  }
+
+  /* Return the description of REGNUM, which must be available in this
+     architecture.  */
+  const register_info_t &register_info (amdgpu_regnum_t regnum) const
+  {
+    dbgapi_assert (is_register_available (regnum));
+    return *m_register_infos[static_cast<size_t> (regnum)];
+  }
+
+  /* Return the register mapped to DWARF_REGISTER in this architecture.  */
+  std::optional<amdgpu_regnum_t>
+  dwarf_register_to_regnum (uint64_t dwarf_register) const
+  {
+    auto it = m_dwarf_register_map.find (dwarf_register);
+    return it != m_dwarf_register_map.end () ? std::make_optional (it->second)
+                                             : std::nullopt;
+  }
 
   virtual bool is_pseudo_register_available (const wave_t &wave,
                                              amdgpu_regnum_t regnum) const = 0;
@@ -102,23 +102,8 @@ amd_dbgapi_process_dispatch_list (amd_dbgapi_process_id_t process_id,
     if (dispatches == nullptr || dispatch_count == nullptr)
       THROW (AMD_DBGAPI_STATUS_ERROR_INVALID_ARGUMENT);
 
-    std::vector<std::pair<process_t *, std::vector<queue_t *>>>
-      queues_needing_resume;
-
-    for (auto &&process : processes)
-      {
-        process->update_queues ();
-
-        std::vector<queue_t *> queues;
-        for (auto &&queue : process->range<queue_t> ())
-          if (!queue.is_suspended ())
-            queues.emplace_back (&queue);
-
-        process->suspend_queues (queues, "refresh dispatch list");
-
-        if (process->forward_progress_needed ())
-          queues_needing_resume.emplace_back (process, std::move (queues));
-      }
+    auto queues_needing_resume
+      = utils::suspend_queues (processes, "refresh dispatch list");
 
     amd_dbgapi_changed_t dispatch_list_changed;
     auto dispatch_list = utils::get_handle_list<dispatch_t> (
@@ -127,8 +112,7 @@ amd_dbgapi_process_dispatch_list (amd_dbgapi_process_id_t process_id,
     auto deallocate_dispatch_list = utils::make_scope_fail (
       [&] () { amd::dbgapi::deallocate_memory (dispatches); });
 
-    for (auto &&[process, queues] : queues_needing_resume)
-      process->resume_queues (queues, "refresh dispatch list");
+    utils::resume_queues (queues_needing_resume, "refresh dispatch list");
 
     std::tie (*dispatches, *dispatch_count) = dispatch_list;
     if (changed != nullptr)
@@ -142,3 +126,62 @@ amd_dbgapi_process_dispatch_list (amd_dbgapi_process_id_t process_id,
              make_ref (make_ref (param_out (dispatches)), *dispatch_count),
              make_ref (param_out (changed)));
 }
+
+amd_dbgapi_status_t AMD_DBGAPI
+amd_dbgapi_process_dispatch_list_delta (
+  amd_dbgapi_process_id_t process_id, amd_dbgapi_list_cursor_t *cursor,
+  amd_dbgapi_list_delta_t *delta_kind, size_t *added_count,
+  amd_dbgapi_dispatch_id_t **added, size_t *removed_count,
+  amd_dbgapi_dispatch_id_t **removed)
+{
+  TRACE_BEGIN (param_in (process_id), param_in (cursor),
+               param_in (delta_kind), param_in (added_count),
+               param_in (added), param_in (removed_count),
+               param_in (removed));
+  TRY
+  {
+    if (!detail::is_initialized)
+      THROW (AMD_DBGAPI_STATUS_ERROR_NOT_INITIALIZED);
+
+    std::vector<process_t *> processes = process_t::match (process_id);
+
+    if (cursor == nullptr || delta_kind == nullptr || added == nullptr
+        || added_count == nullptr || removed == nullptr
+        || removed_count == nullptr)
+      THROW (AMD_DBGAPI_STATUS_ERROR_INVALID_ARGUMENT);
+
+    auto queues_needing_resume
+      = utils::suspend_queues (processes, "refresh dispatch list");
+
+    amd_dbgapi_list_cursor_t dispatch_list_cursor = *cursor;
+    amd_dbgapi_list_delta_t dispatch_list_delta_kind;
+    auto [added_list, added_list_count, removed_list, removed_list_count]
+      = utils::get_handle_list_delta<dispatch_t> (
+        processes, &dispatch_list_cursor, &dispatch_list_delta_kind);
+
+    auto deallocate_dispatch_lists = utils::make_scope_fail (
+      [added_list = added_list, removed_list = removed_list] ()
+      {
+        amd::dbgapi::deallocate_memory (added_list);
+        amd::dbgapi::deallocate_memory (removed_list);
+      });
+
+    utils::resume_queues (queues_needing_resume, "refresh dispatch list");
+
+    *cursor = dispatch_list_cursor;
+    *delta_kind = dispatch_list_delta_kind;
+    *added = added_list;
+    *added_count = added_list_count;
+    *removed = removed_list;
+    *removed_count = removed_list_count;
+  }
+  CATCH (AMD_DBGAPI_STATUS_ERROR_NOT_INITIALIZED,
+         AMD_DBGAPI_STATUS_ERROR_INVALID_PROCESS_ID,
+         AMD_DBGAPI_STATUS_ERROR_INVALID_ARGUMENT,
+         AMD_DBGAPI_STATUS_ERROR_CLIENT_CALLBACK);
+  TRACE_END (make_ref (param_out (cursor)), make_ref (param_out (delta_kind)),
+             make_ref (param_out (added_count)),
+             make_ref (make_ref (param_out (added)), *added_count),
+             make_ref (param_out (removed_count)),
+             make_ref (make_ref (param_out (removed)), *removed_count));
+}
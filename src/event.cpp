@@ -30,12 +30,83 @@
 #include "wave.h"
 
 #include <cinttypes>
+#include <mutex>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace amd::dbgapi
 {
 
+namespace
+{
+
+/* Storage of destroyed events, kept for reuse by the next events created.
+   Once the pool holds event_pool_max_size entries, the storage of destroyed
+   events is freed.  The pool is shared by all the processes, and is
+   protected by event_pool_mutex so that events can be created and destroyed
+   from any thread.  */
+constexpr size_t event_pool_max_size = 1024;
+std::vector<void *> event_pool;
+std::mutex event_pool_mutex;
+
+} /* namespace */
+
+void *
+event_t::operator new (size_t size)
+{
+  dbgapi_assert (size == sizeof (event_t) && "invalid event size");
+
+  {
+    std::lock_guard<std::mutex> lock (event_pool_mutex);
+
+    if (!event_pool.empty ())
+      {
+        void *ptr = event_pool.back ();
+        event_pool.pop_back ();
+        return ptr;
+      }
+  }
+
+  return ::operator new (size);
+}
+
+void
+event_t::operator delete (void *ptr, size_t size)
+{
+  dbgapi_assert (size == sizeof (event_t) && "invalid event size");
+
+  {
+    std::lock_guard<std::mutex> lock (event_pool_mutex);
+
+    if (event_pool.size () < event_pool_max_size)
+      {
+        /* Reserve the pool's capacity up front so that returning storage to
+           the pool never allocates.  */
+        if (event_pool.capacity () < event_pool_max_size)
+          event_pool.reserve (event_pool_max_size);
+        event_pool.emplace_back (ptr);
+        return;
+      }
+  }
+
+  ::operator delete (ptr);
+}
+
+void
+event_t::release_pool ()
+{
+  std::vector<void *> pool;
+
+  {
+    std::lock_guard<std::mutex> lock (event_pool_mutex);
+    pool.swap (event_pool);
+  }
+
+  for (void *ptr : pool)
+    ::operator delete (ptr);
+}
+
 /* Breakpoint resume event.  */
 event_t::event_t (amd_dbgapi_event_id_t event_id, process_t &process,
                   amd_dbgapi_event_kind_t event_kind,
@@ -163,13 +234,6 @@ event_t::set_state (state_t state)
         {
           process ().update_queues ();
 
-          std::vector<queue_t *> queues;
-          queues.reserve (process ().count<queue_t> ());
-
-          for (auto &&queue : process ().range<queue_t> ())
-            if (!queue.is_suspended ())
-              queues.emplace_back (&queue);
-
           /* FIXME: A breakpoint may have been inserted by the client prior to
              reporting this event as processed.
 
@@ -185,7 +249,35 @@ event_t::set_state (state_t state)
              The ROCr runtime creates an internal queue to run the blit kernels
              so, after loading a device code object, we should always have at
              least one queue on each device.  Suspending that queue to update
-             the wave list causes the caches to be flushed.  */
+             the wave list causes the caches to be flushed.
+
+             Suspending one queue is enough to flush the caches of its agent,
+             so only one running queue per agent is suspended.  The client may
+             insert breakpoints without going through the library (with ptrace
+             for example), so every agent with a running queue is flushed.  */
+
+          std::unordered_map<amd_dbgapi_agent_id_t, queue_t *,
+                             hash<amd_dbgapi_agent_id_t>>
+            agent_queues;
+          size_t running_queue_count = 0;
+
+          for (auto &&queue : process ().range<queue_t> ())
+            if (!queue.is_suspended ())
+              {
+                ++running_queue_count;
+                if (!queue.is_all_stopped ())
+                  agent_queues.try_emplace (queue.agent ().id (), &queue);
+              }
+
+          std::vector<queue_t *> queues;
+          queues.reserve (agent_queues.size ());
+          for (auto &&[agent_id, queue] : agent_queues)
+            queues.emplace_back (queue);
+
+          auto &statistics = process ().statistics ();
+          statistics.code_object_flush_queue_count += queues.size ();
+          statistics.code_object_flush_avoided_queue_count
+            += running_queue_count - queues.size ();
 
           process ().suspend_queues (queues, "code object list updated");
           if (process ().forward_progress_needed ())
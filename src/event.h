@@ -122,6 +122,15 @@ public:
   std::string pretty_printer_string () const;
 
   process_t &process () const { return m_process; }
+
+  /* Events are created and destroyed at a high rate, so their storage is
+     recycled instead of being returned to the heap.  */
+  static void *operator new (size_t size);
+  static void operator delete (void *ptr, size_t size);
+
+  /* Free the storage kept for reuse.  Called when the library is
+     finalized, once all the events are destroyed.  */
+  static void release_pool ();
 };
 
 } /* namespace amd::dbgapi */
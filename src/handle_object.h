@@ -24,9 +24,12 @@
 #include "utils.h"
 
 #include <algorithm>
+#include <deque>
 #include <memory>
+#include <optional>
 #include <type_traits>
 #include <unordered_map>
+#include <vector>
 
 namespace amd::dbgapi
 {
@@ -183,6 +186,37 @@ private:
   /* Map holding the objects, keyed by object::id ()'s return type. */
   map_type m_map{};
 
+  /* History of the objects becoming valid (created, or made valid) and
+     becoming invalid (destroyed, or made invalid).  Each entry is stamped
+     with a history epoch, and is used to compute the list of objects added
+     to, and removed from, the set since a given epoch.  */
+  struct history_entry_t
+  {
+    epoch_t epoch;
+    handle_type id;
+    bool valid;
+  };
+  std::deque<history_entry_t> m_history{};
+
+  /* Epoch of the most recent entry trimmed from the history.  The history
+     cannot answer a delta request for an epoch older than this.  */
+  epoch_t m_history_floor{ 0 };
+
+  void record_history (handle_type id, bool valid)
+  {
+    m_history.emplace_back (history_entry_t{ next_history_epoch () (), id,
+                                             valid });
+
+    /* Keep the history bounded by the number of objects in the set, so that
+       sets with a high churn (e.g. waves) do not grow the history forever.
+     */
+    while (m_history.size () > 2 * m_map.size () + 1024)
+      {
+        m_history_floor = m_history.front ().epoch;
+        m_history.pop_front ();
+      }
+  }
+
 public:
   class iterator
   {
@@ -298,6 +332,9 @@ public:
     auto object_it = m_map.find (object->id ());
     dbgapi_assert (object_it != m_map.end ());
 
+    if (is_valid (*object_it->second))
+      record_history (object_it->first, false);
+
     m_changed = true;
     m_map.erase (object_it);
   }
@@ -306,9 +343,71 @@ public:
   {
     m_changed = true;
     typename map_type::iterator it = object_it.get ();
+
+    if (is_valid (*it->second))
+      record_history (it->first, false);
+
     return iterator (m_map.erase (it));
   }
 
+  /* Record that the validity of the given object has changed.  This must be
+     called by objects implementing the is_valid concept whenever is_valid ()
+     changes value.  */
+  void validity_changed (const Object &object)
+  {
+    m_changed = true;
+    record_history (object.id (), is_valid (object));
+  }
+
+  /* Return the current history epoch.  Changes made to the set after this
+     call are stamped with a greater epoch.  */
+  static epoch_t history_epoch () { return next_history_epoch () (); }
+
+  /* Return the ids of the valid objects that were added to the set, and the
+     ids of the objects that were removed from the set (destroyed or made
+     invalid) since EPOCH.  Objects both added and removed since EPOCH are
+     not returned.  Return an empty optional if the history does not go as
+     far back as EPOCH.  */
+  std::optional<std::pair<std::vector<handle_type> /* added */,
+                          std::vector<handle_type> /* removed */>>
+  delta (epoch_t epoch) const
+  {
+    if (epoch < m_history_floor)
+      return std::nullopt;
+
+    /* The entries are sorted by increasing epoch, find the first entry
+       recorded after EPOCH.  */
+    auto first = std::upper_bound (
+      m_history.begin (), m_history.end (), epoch,
+      [] (epoch_t value, const history_entry_t &entry)
+      { return value < entry.epoch; });
+
+    /* For each object, record whether it was valid at EPOCH (the opposite of
+       its first transition) and whether it is valid now (its last
+       transition).  */
+    std::unordered_map<handle_type, std::pair<bool, bool>, hash<handle_type>>
+      transitions;
+    for (auto it = first; it != m_history.end (); ++it)
+      {
+        auto [transition, inserted] = transitions.emplace (
+          it->id, std::make_pair (!it->valid, it->valid));
+        if (!inserted)
+          transition->second.second = it->valid;
+      }
+
+    std::vector<handle_type> added, removed;
+    for (auto &&[id, transition] : transitions)
+      {
+        auto [was_valid, now_valid] = transition;
+        if (!was_valid && now_valid)
+          added.emplace_back (id);
+        else if (was_valid && !now_valid)
+          removed.emplace_back (id);
+      }
+
+    return std::make_pair (std::move (added), std::move (removed));
+  }
+
   /* The find() and find_if() operations hide any !is_valid() objects unless
     'all' is specified as 'true'.  This is important for the find_if() as the
     predicate may match multiple objects, of which only one is_valid().
@@ -381,6 +480,10 @@ public:
   {
     if (!m_map.empty ())
       {
+        for (auto &&[id, object] : m_map)
+          if (is_valid (*object))
+            record_history (id, false);
+
         m_changed = true;
         m_map.clear ();
       }
@@ -401,6 +504,15 @@ public:
       counter;
     return counter;
   }
+
+  static auto &next_history_epoch ()
+  {
+    /* Counter to stamp the history entries.  It is shared by all the sets
+       holding the same Object type so that epochs can be compared across
+       processes.  */
+    static monotonic_counter_t<epoch_t, 1> counter;
+    return counter;
+  }
 };
 
 template <typename Object>
@@ -428,6 +540,7 @@ handle_object_set_t<Object>::create_object (std::optional<handle_type> id,
       fatal_error ("object is not valid");
     }
 
+  record_history (*id, true);
   m_changed = true;
   return *static_cast<Derived *> (it->second.get ());
 }
@@ -20,6 +20,7 @@
 
 #include "amd-dbgapi.h"
 #include "debug.h"
+#include "event.h"
 #include "exception.h"
 #include "logging.h"
 #include "process.h"
@@ -101,6 +102,9 @@ amd_dbgapi_finalize ()
         process.detach ();
         process_t::destroy_process (&process);
       }
+
+    /* The events were destroyed with their process, free their storage.  */
+    event_t::release_pool ();
   }
   CATCH (AMD_DBGAPI_STATUS_ERROR_NOT_INITIALIZED,
          AMD_DBGAPI_STATUS_ERROR_CLIENT_CALLBACK);
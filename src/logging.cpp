@@ -300,6 +300,94 @@ to_string (amd_dbgapi_changed_t changed)
   return to_string (make_hex (changed));
 }
 
+template <>
+std::string
+to_string (amd_dbgapi_list_delta_t delta_kind)
+{
+  switch (delta_kind)
+    {
+      CASE (LIST_DELTA_INCREMENTAL);
+      CASE (LIST_DELTA_FULL);
+    }
+  return to_string (make_hex (delta_kind));
+}
+
+template <>
+std::string
+to_string (amd_dbgapi_breakpoint_condition_kind_t kind)
+{
+  switch (kind)
+    {
+      CASE (BREAKPOINT_CONDITION_REGISTER);
+      CASE (BREAKPOINT_CONDITION_ACTIVE_LANE_COUNT);
+      CASE (BREAKPOINT_CONDITION_WORKGROUP_COORD);
+      CASE (BREAKPOINT_CONDITION_HIT_COUNT);
+    }
+  return to_string (make_hex (kind));
+}
+
+template <>
+std::string
+to_string (amd_dbgapi_breakpoint_condition_comparison_t comparison)
+{
+  switch (comparison)
+    {
+      CASE (BREAKPOINT_CONDITION_EQUAL);
+      CASE (BREAKPOINT_CONDITION_NOT_EQUAL);
+      CASE (BREAKPOINT_CONDITION_LESS);
+      CASE (BREAKPOINT_CONDITION_LESS_EQUAL);
+      CASE (BREAKPOINT_CONDITION_GREATER);
+      CASE (BREAKPOINT_CONDITION_GREATER_EQUAL);
+    }
+  return to_string (make_hex (comparison));
+}
+
+template <>
+std::string
+to_string (amd_dbgapi_breakpoint_condition_term_t term)
+{
+  return string_printf (
+    "{kind %s, comparison %s, register_id %s, dimension %s, value %s}",
+    to_cstring (term.kind), to_cstring (term.comparison),
+    to_cstring (term.register_id), to_cstring (term.dimension),
+    to_cstring (make_hex (term.value)));
+}
+
+template <>
+std::string
+to_string (amd_dbgapi_local_memory_snapshot_kind_t kind)
+{
+  switch (kind)
+    {
+      CASE (LOCAL_MEMORY_SNAPSHOT_FULL);
+      CASE (LOCAL_MEMORY_SNAPSHOT_DIFF);
+    }
+  return to_string (make_hex (kind));
+}
+
+template <>
+std::string
+to_string (amd_dbgapi_local_memory_range_t range)
+{
+  return string_printf (
+    "{workgroup_id %s, offset %s, size %s, bytes_offset %s}",
+    to_cstring (range.workgroup_id), to_cstring (make_hex (range.offset)),
+    to_cstring (range.size), to_cstring (range.bytes_offset));
+}
+
+template <>
+std::string
+to_string (amd_dbgapi_stop_reason_action_t action)
+{
+  switch (action)
+    {
+      CASE (STOP_REASON_ACTION_REPORT);
+      CASE (STOP_REASON_ACTION_RESUME);
+      CASE (STOP_REASON_ACTION_TERMINATE);
+    }
+  return to_string (make_hex (action));
+}
+
 template <>
 std::string
 to_string (amd_dbgapi_status_t status)
@@ -575,6 +663,7 @@ to_string (amd_dbgapi_client_process_info_t client_process_info)
     {
       CASE (CLIENT_PROCESS_INFO_OS_PID);
       CASE (CLIENT_PROCESS_INFO_CORE_STATE);
+      CASE (CLIENT_PROCESS_INFO_GPU_SNAPSHOT);
     }
   return to_string (make_hex (client_process_info));
 }
@@ -602,6 +691,8 @@ to_string (detail::query_ref<amd_dbgapi_client_process_info_t> ref)
     case AMD_DBGAPI_CLIENT_PROCESS_INFO_CORE_STATE:
       return to_string (
         make_ref (static_cast<const amd_dbgapi_core_state_data_t *> (value)));
+    case AMD_DBGAPI_CLIENT_PROCESS_INFO_GPU_SNAPSHOT:
+      return to_string (make_ref (static_cast<const int *> (value)));
     }
   fatal_error ("unhandled amd_dbgapi_client_process_info_t query (%s)",
                to_cstring (query));
@@ -620,6 +711,7 @@ to_string (amd_dbgapi_process_info_t process_info)
       CASE (PROCESS_INFO_OS_ID);
       CASE (PROCESS_INFO_CORE_STATE);
       CASE (PROCESS_INFO_PRECISE_ALU_EXCEPTIONS_SUPPORTED);
+      CASE (PROCESS_INFO_STATISTICS);
     }
   return to_string (make_hex (process_info));
 }
@@ -651,11 +743,30 @@ to_string (detail::query_ref<amd_dbgapi_process_info_t> ref)
     case AMD_DBGAPI_PROCESS_INFO_PRECISE_ALU_EXCEPTIONS_SUPPORTED:
       return to_string (make_ref (
         static_cast<const amd_dbgapi_alu_exceptions_precision_t *> (value)));
+    case AMD_DBGAPI_PROCESS_INFO_STATISTICS:
+      return to_string (make_ref (
+        static_cast<const amd_dbgapi_process_statistics_t *> (value)));
     }
   fatal_error ("unhandled amd_dbgapi_process_info_t query (%s)",
                to_cstring (query));
 }
 
+template <>
+std::string
+to_string (amd_dbgapi_process_statistics_t statistics)
+{
+  return string_printf (
+    "{code_object_flush_queue_count %s, "
+    "code_object_flush_avoided_queue_count %s, "
+    "breakpoint_condition_resume_count %s, stop_reason_resume_count %s, "
+    "stop_reason_terminate_count %s}",
+    to_cstring (statistics.code_object_flush_queue_count),
+    to_cstring (statistics.code_object_flush_avoided_queue_count),
+    to_cstring (statistics.breakpoint_condition_resume_count),
+    to_cstring (statistics.stop_reason_resume_count),
+    to_cstring (statistics.stop_reason_terminate_count));
+}
+
 template <>
 std::string
 to_string (amd_dbgapi_progress_t progress)
@@ -668,6 +779,18 @@ to_string (amd_dbgapi_progress_t progress)
   return to_string (make_hex (progress));
 }
 
+template <>
+std::string
+to_string (amd_dbgapi_event_processing_t event_processing)
+{
+  switch (event_processing)
+    {
+      CASE (EVENT_PROCESSING_SYNCHRONOUS);
+      CASE (EVENT_PROCESSING_PIPELINED);
+    }
+  return to_string (make_hex (event_processing));
+}
+
 template <>
 std::string
 to_string (amd_dbgapi_wave_creation_t wave_creation)
@@ -1253,6 +1376,60 @@ to_string (amd_dbgapi_wave_stop_reasons_t stop_reason)
   return str;
 }
 
+template <>
+std::string
+to_string (amd_dbgapi_wave_filter_t filter)
+{
+  std::string str;
+  auto append = [&str] (const std::string &criterion)
+  {
+    if (!str.empty ())
+      str += ", ";
+    str += criterion;
+  };
+
+  if (filter.kinds & AMD_DBGAPI_WAVE_FILTER_STATE)
+    append ("state " + to_string (filter.state));
+  if (filter.kinds & AMD_DBGAPI_WAVE_FILTER_STOP_REASON)
+    append ("stop_reasons " + to_string (filter.stop_reasons));
+  if (filter.kinds & AMD_DBGAPI_WAVE_FILTER_PC_RANGE)
+    append ("pc [" + to_string (make_hex (filter.pc_begin)) + ".."
+            + to_string (make_hex (filter.pc_end)) + "[");
+  if (filter.kinds & AMD_DBGAPI_WAVE_FILTER_QUEUE)
+    append ("queue " + to_string (filter.queue_id));
+  if (filter.kinds & AMD_DBGAPI_WAVE_FILTER_DISPATCH)
+    append ("dispatch " + to_string (filter.dispatch_id));
+  if (filter.kinds & AMD_DBGAPI_WAVE_FILTER_AGENT)
+    append ("agent " + to_string (filter.agent_id));
+
+  return "{" + str + "}";
+}
+
+template <>
+std::string
+to_string (amd_dbgapi_wave_summary_t summary)
+{
+  return string_printf ("{%s, %s, %s, %zu}", to_cstring (summary.queue_id),
+                        to_cstring (summary.state),
+                        to_cstring (summary.stop_reason), summary.wave_count);
+}
+
+template <>
+std::string
+to_string (amd_dbgapi_queue_dispatch_packet_t dispatch_packet)
+{
+  return string_printf (
+    "{%s, %u, [%u, %u, %u], [%u, %u, %u], %u, %u, %s, %s}",
+    to_cstring (make_hex (dispatch_packet.packet_id)),
+    dispatch_packet.grid_dimensions, dispatch_packet.grid_sizes[0],
+    dispatch_packet.grid_sizes[1], dispatch_packet.grid_sizes[2],
+    dispatch_packet.workgroup_sizes[0], dispatch_packet.workgroup_sizes[1],
+    dispatch_packet.workgroup_sizes[2], dispatch_packet.private_segment_size,
+    dispatch_packet.group_segment_size,
+    to_cstring (make_hex (dispatch_packet.kernel_descriptor_address)),
+    to_cstring (make_hex (dispatch_packet.kernel_argument_segment_address)));
+}
+
 template <>
 std::string
 to_string (amd_dbgapi_resume_mode_t resume_mode)
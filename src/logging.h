@@ -479,6 +479,9 @@ to_string (detail::parameter_t<detail::query_ref<T>, name, kind> param)
   F (amd_dbgapi_architecture_id_t)                                            \
   F (amd_dbgapi_architecture_info_t)                                          \
   F (amd_dbgapi_breakpoint_action_t)                                          \
+  F (amd_dbgapi_breakpoint_condition_comparison_t)                            \
+  F (amd_dbgapi_breakpoint_condition_kind_t)                                  \
+  F (amd_dbgapi_breakpoint_condition_term_t)                                  \
   F (amd_dbgapi_breakpoint_id_t)                                              \
   F (amd_dbgapi_breakpoint_info_t)                                            \
   F (amd_dbgapi_changed_t)                                                    \
@@ -496,16 +499,22 @@ to_string (detail::parameter_t<detail::query_ref<T>, name, kind> param)
   F (amd_dbgapi_event_id_t)                                                   \
   F (amd_dbgapi_event_info_t)                                                 \
   F (amd_dbgapi_event_kind_t)                                                 \
+  F (amd_dbgapi_event_processing_t)                                           \
   F (amd_dbgapi_exceptions_t)                                                 \
   F (amd_dbgapi_instruction_kind_t)                                           \
   F (amd_dbgapi_instruction_properties_t)                                     \
+  F (amd_dbgapi_list_delta_t)                                                 \
+  F (amd_dbgapi_local_memory_range_t)                                         \
+  F (amd_dbgapi_local_memory_snapshot_kind_t)                                 \
   F (amd_dbgapi_log_level_t)                                                  \
   F (amd_dbgapi_memory_precision_t)                                           \
   F (amd_dbgapi_alu_exceptions_precision_t)                                   \
   F (amd_dbgapi_os_queue_type_t)                                              \
   F (amd_dbgapi_process_id_t)                                                 \
   F (amd_dbgapi_process_info_t)                                               \
+  F (amd_dbgapi_process_statistics_t)                                         \
   F (amd_dbgapi_progress_t)                                                   \
+  F (amd_dbgapi_queue_dispatch_packet_t)                                      \
   F (amd_dbgapi_queue_id_t)                                                   \
   F (amd_dbgapi_queue_info_t)                                                 \
   F (amd_dbgapi_queue_state_t)                                                \
@@ -519,11 +528,14 @@ to_string (detail::parameter_t<detail::query_ref<T>, name, kind> param)
   F (amd_dbgapi_resume_mode_t)                                                \
   F (amd_dbgapi_runtime_state_t)                                              \
   F (amd_dbgapi_status_t)                                                     \
+  F (amd_dbgapi_stop_reason_action_t)                                         \
   F (amd_dbgapi_wave_creation_t)                                              \
+  F (amd_dbgapi_wave_filter_t)                                                \
   F (amd_dbgapi_wave_id_t)                                                    \
   F (amd_dbgapi_wave_info_t)                                                  \
   F (amd_dbgapi_wave_state_t)                                                 \
   F (amd_dbgapi_wave_stop_reasons_t)                                          \
+  F (amd_dbgapi_wave_summary_t)                                               \
   F (amd_dbgapi_watchpoint_id_t)                                              \
   F (amd_dbgapi_watchpoint_info_t)                                            \
   F (amd_dbgapi_watchpoint_kind_t)                                            \
@@ -29,6 +29,7 @@
 #include "utils.h"
 #include "wave.h"
 
+#include <algorithm>
 #include <cstring>
 #include <exception>
 #include <optional>
@@ -504,20 +505,21 @@ memory_cache_t::prefetch (amd_dbgapi_global_address_t address,
   auto cache_line_begin = utils::align_down (address, cache_line_size);
   auto cache_line_end = utils::align_up (address + size, cache_line_size);
 
+  /* Nothing to do if all the cache lines are already valid.  */
+  if (contains_all (cache_line_begin, cache_line_end - cache_line_begin))
+    return;
+
   auto staging_buffer
     = std::make_unique<std::byte[]> (cache_line_end - cache_line_begin);
 
-  try
-    {
-      m_xfer_global_memory (cache_line_begin, &staging_buffer[0], nullptr,
+  size_t xfer_size
+    = m_xfer_global_memory (cache_line_begin, &staging_buffer[0], nullptr,
                             cache_line_end - cache_line_begin);
-    }
-  catch (const memory_access_error_t &)
-    {
-      /* If a memory access error exception is raised while prefetching, simply
-         drop the prefetch.  */
-      return;
-    }
+
+  /* Only cache the lines that were entirely transferred.  If the memory is
+     not accessible, simply drop the rest of the prefetch.  */
+  cache_line_end
+    = cache_line_begin + utils::align_down (xfer_size, cache_line_size);
 
   for (auto cache_line_address = cache_line_begin;
        cache_line_address < cache_line_end;
@@ -540,9 +542,43 @@ memory_cache_t::prefetch (amd_dbgapi_global_address_t address,
     }
 }
 
+void
+memory_cache_t::prefetch (
+  std::vector<std::pair<amd_dbgapi_global_address_t, amd_dbgapi_size_t>>
+    ranges,
+  amd_dbgapi_size_t max_gap)
+{
+  if (policy == policy_t::uncached || ranges.empty ())
+    return;
+
+  std::sort (ranges.begin (), ranges.end ());
+
+  auto group_begin = utils::align_down (ranges.front ().first, cache_line_size);
+  auto group_end = group_begin;
+
+  for (auto &&[address, size] : ranges)
+    {
+      if (size == 0)
+        continue;
+
+      auto range_begin = utils::align_down (address, cache_line_size);
+      auto range_end = utils::align_up (address + size, cache_line_size);
+
+      if (range_begin > group_end + max_gap)
+        {
+          prefetch (group_begin, group_end - group_begin);
+          group_begin = range_begin;
+        }
+
+      group_end = std::max (group_end, range_end);
+    }
+
+  prefetch (group_begin, group_end - group_begin);
+}
+
 void
 memory_cache_t::write_back (amd_dbgapi_global_address_t address,
-                            amd_dbgapi_size_t size)
+                            amd_dbgapi_size_t size, amd_dbgapi_size_t max_gap)
 {
   std::exception_ptr exception;
   if (policy != policy_t::write_back || size == 0)
@@ -572,14 +608,20 @@ memory_cache_t::write_back (amd_dbgapi_global_address_t address,
         }
 
       /* It is more efficient to do a single large memory access, so try to
-         group as many contiguous cache lines as possible.  */
+         group as many contiguous cache lines as possible.  Clean cache lines
+         are only included in the group if they are followed by a dirty cache
+         line within MAX_GAP bytes.  */
       auto next = std::next (it);
-      while (next != limit && next->second.m_dirty
-             && next->first == (cache_line_address + request_size))
-        {
-          request_size += cache_line_size;
-          std::advance (next, 1);
-        }
+      auto scan_address = cache_line_address + cache_line_size;
+      for (auto scan = next;
+           scan != limit && scan->first == scan_address
+           && scan_address - (cache_line_address + request_size) <= max_gap;
+           std::advance (scan, 1), scan_address += cache_line_size)
+        if (scan->second.m_dirty)
+          {
+            request_size = scan_address + cache_line_size - cache_line_address;
+            next = std::next (scan);
+          }
 
       if (request_size > staging_buffer_size)
         {
@@ -1131,7 +1173,11 @@ amd_dbgapi_address_dependency (
 namespace
 {
 
-void
+/* Validate the arguments and transfer the memory of amd_dbgapi_read_memory
+   and amd_dbgapi_write_memory.  Argument errors and inaccessible memory are
+   returned as a status rather than thrown, as clients such as debuggers
+   commonly probe addresses and waves that turn out to be invalid.  */
+amd_dbgapi_status_t
 xfer_memory (amd_dbgapi_process_id_t process_id, amd_dbgapi_wave_id_t wave_id,
              amd_dbgapi_lane_id_t lane_id,
              amd_dbgapi_address_space_id_t address_space_id,
@@ -1139,42 +1185,44 @@ xfer_memory (amd_dbgapi_process_id_t process_id, amd_dbgapi_wave_id_t wave_id,
              amd_dbgapi_size_t *value_size, void *read, const void *write)
 {
   if (!detail::is_initialized)
-    THROW (AMD_DBGAPI_STATUS_ERROR_NOT_INITIALIZED);
+    return AMD_DBGAPI_STATUS_ERROR_NOT_INITIALIZED;
 
   process_t *process = process_t::find (process_id);
 
   if (process == nullptr)
-    THROW (AMD_DBGAPI_STATUS_ERROR_INVALID_PROCESS_ID);
+    return AMD_DBGAPI_STATUS_ERROR_INVALID_PROCESS_ID;
 
   if ((read == nullptr) == (write == nullptr) || value_size == nullptr)
-    THROW (AMD_DBGAPI_STATUS_ERROR_INVALID_ARGUMENT);
+    return AMD_DBGAPI_STATUS_ERROR_INVALID_ARGUMENT;
 
   if (process->is_frozen () && write != nullptr)
-    THROW (AMD_DBGAPI_STATUS_ERROR_PROCESS_FROZEN);
+    return AMD_DBGAPI_STATUS_ERROR_PROCESS_FROZEN;
 
   const address_space_t *address_space = find (address_space_id);
 
   if (address_space == nullptr)
-    THROW (AMD_DBGAPI_STATUS_ERROR_INVALID_ADDRESS_SPACE_ID);
+    return AMD_DBGAPI_STATUS_ERROR_INVALID_ADDRESS_SPACE_ID;
 
   wave_t *wave = find (wave_id);
 
   if (wave != nullptr)
     {
       if (wave->state () != AMD_DBGAPI_WAVE_STATE_STOP)
-        THROW (AMD_DBGAPI_STATUS_ERROR_WAVE_NOT_STOPPED);
+        return AMD_DBGAPI_STATUS_ERROR_WAVE_NOT_STOPPED;
 
       if (!wave->architecture ().is_address_space_supported (*address_space)
           || wave->process () != *process)
-        THROW (AMD_DBGAPI_STATUS_ERROR_INVALID_ARGUMENT_COMPATIBILITY);
+        return AMD_DBGAPI_STATUS_ERROR_INVALID_ARGUMENT_COMPATIBILITY;
 
       if (lane_id != AMD_DBGAPI_LANE_NONE && lane_id >= wave->lane_count ())
-        THROW (AMD_DBGAPI_STATUS_ERROR_INVALID_LANE_ID);
+        return AMD_DBGAPI_STATUS_ERROR_INVALID_LANE_ID;
     }
   else if (wave_id != AMD_DBGAPI_WAVE_NONE)
-    THROW (AMD_DBGAPI_STATUS_ERROR_INVALID_WAVE_ID);
+    return AMD_DBGAPI_STATUS_ERROR_INVALID_WAVE_ID;
   else if (lane_id != AMD_DBGAPI_LANE_NONE)
-    THROW (AMD_DBGAPI_STATUS_ERROR_INVALID_LANE_ID);
+    return AMD_DBGAPI_STATUS_ERROR_INVALID_LANE_ID;
+
+  const amd_dbgapi_size_t request_size = *value_size;
 
   try
     {
@@ -1187,7 +1235,7 @@ xfer_memory (amd_dbgapi_process_id_t process_id, amd_dbgapi_wave_id_t wave_id,
 
         case AMD_DBGAPI_SEGMENT_ADDRESS_DEPENDENCE_WORKGROUP:
           if (wave == nullptr)
-            THROW (AMD_DBGAPI_STATUS_ERROR_INVALID_WAVE_ID);
+            return AMD_DBGAPI_STATUS_ERROR_INVALID_WAVE_ID;
 
           *value_size = wave->workgroup ().xfer_segment_memory (
             *address_space, segment_address, read, write, *value_size);
@@ -1195,12 +1243,12 @@ xfer_memory (amd_dbgapi_process_id_t process_id, amd_dbgapi_wave_id_t wave_id,
 
         case AMD_DBGAPI_SEGMENT_ADDRESS_DEPENDENCE_LANE:
           if (lane_id == AMD_DBGAPI_LANE_NONE)
-            THROW (AMD_DBGAPI_STATUS_ERROR_INVALID_LANE_ID);
+            return AMD_DBGAPI_STATUS_ERROR_INVALID_LANE_ID;
           [[fallthrough]];
 
         case AMD_DBGAPI_SEGMENT_ADDRESS_DEPENDENCE_WAVE:
           if (wave == nullptr)
-            THROW (AMD_DBGAPI_STATUS_ERROR_INVALID_WAVE_ID);
+            return AMD_DBGAPI_STATUS_ERROR_INVALID_WAVE_ID;
 
           *value_size
             = wave->xfer_segment_memory (*address_space, segment_address,
@@ -1216,8 +1264,15 @@ xfer_memory (amd_dbgapi_process_id_t process_id, amd_dbgapi_wave_id_t wave_id,
       /* The API specification requires the value_size to return 0 if a memory
          access error is reported.  */
       *value_size = 0;
-      throw;
+      return AMD_DBGAPI_STATUS_ERROR_MEMORY_ACCESS;
     }
+
+  /* A transfer that could not access the first byte is a memory access
+     error.  */
+  if (request_size != 0 && *value_size == 0)
+    return AMD_DBGAPI_STATUS_ERROR_MEMORY_ACCESS;
+
+  return AMD_DBGAPI_STATUS_SUCCESS;
 }
 
 } /* namespace */
@@ -1236,8 +1291,11 @@ amd_dbgapi_read_memory (amd_dbgapi_process_id_t process_id,
                make_ref (param_in (value_size)), param_in (value));
   TRY
   {
-    xfer_memory (process_id, wave_id, lane_id, address_space_id,
-                 segment_address, value_size, value, nullptr);
+    if (amd_dbgapi_status_t status
+        = xfer_memory (process_id, wave_id, lane_id, address_space_id,
+                       segment_address, value_size, value, nullptr);
+        status != AMD_DBGAPI_STATUS_SUCCESS)
+      return status;
   }
   CATCH (AMD_DBGAPI_STATUS_ERROR_NOT_INITIALIZED,
          AMD_DBGAPI_STATUS_ERROR_INVALID_PROCESS_ID,
@@ -1252,6 +1310,75 @@ amd_dbgapi_read_memory (amd_dbgapi_process_id_t process_id,
              make_hex (make_ref (param_out (value), *value_size)));
 }
 
+amd_dbgapi_status_t AMD_DBGAPI
+amd_dbgapi_read_memory_all_lanes (
+  amd_dbgapi_wave_id_t wave_id, amd_dbgapi_address_space_id_t address_space_id,
+  amd_dbgapi_segment_address_t segment_address, amd_dbgapi_size_t *value_size,
+  void *values, uint64_t *lane_mask)
+{
+  TRACE_BEGIN (param_in (wave_id), param_in (address_space_id),
+               make_hex (param_in (segment_address)),
+               make_ref (param_in (value_size)), param_in (values),
+               param_in (lane_mask));
+  TRY
+  {
+    if (!detail::is_initialized)
+      THROW (AMD_DBGAPI_STATUS_ERROR_NOT_INITIALIZED);
+
+    wave_t *wave = find (wave_id);
+
+    if (wave == nullptr)
+      THROW (AMD_DBGAPI_STATUS_ERROR_INVALID_WAVE_ID);
+
+    const address_space_t *address_space = find (address_space_id);
+
+    if (address_space == nullptr)
+      THROW (AMD_DBGAPI_STATUS_ERROR_INVALID_ADDRESS_SPACE_ID);
+
+    if (wave->state () != AMD_DBGAPI_WAVE_STATE_STOP)
+      THROW (AMD_DBGAPI_STATUS_ERROR_WAVE_NOT_STOPPED);
+
+    if (value_size == nullptr || values == nullptr || lane_mask == nullptr)
+      THROW (AMD_DBGAPI_STATUS_ERROR_INVALID_ARGUMENT);
+
+    if (!wave->architecture ().is_address_space_supported (*address_space)
+        || address_space->address_dependency (segment_address)
+             != AMD_DBGAPI_SEGMENT_ADDRESS_DEPENDENCE_LANE)
+      THROW (AMD_DBGAPI_STATUS_ERROR_INVALID_ARGUMENT_COMPATIBILITY);
+
+    const uint64_t exec_mask = wave->exec_mask ();
+
+    const amd_dbgapi_size_t request_size = *value_size;
+
+    try
+      {
+        *value_size = wave->read_segment_memory_lanes (
+          *address_space, segment_address, exec_mask, values, *value_size);
+      }
+    catch (const memory_access_error_t &)
+      {
+        /* The API specification requires the value_size to return 0 if a
+           memory access error is reported.  */
+        *value_size = 0;
+        return AMD_DBGAPI_STATUS_ERROR_MEMORY_ACCESS;
+      }
+
+    if (request_size != 0 && *value_size == 0)
+      return AMD_DBGAPI_STATUS_ERROR_MEMORY_ACCESS;
+
+    *lane_mask = exec_mask;
+  }
+  CATCH (AMD_DBGAPI_STATUS_ERROR_NOT_INITIALIZED,
+         AMD_DBGAPI_STATUS_ERROR_INVALID_WAVE_ID,
+         AMD_DBGAPI_STATUS_ERROR_INVALID_ADDRESS_SPACE_ID,
+         AMD_DBGAPI_STATUS_ERROR_WAVE_NOT_STOPPED,
+         AMD_DBGAPI_STATUS_ERROR_INVALID_ARGUMENT,
+         AMD_DBGAPI_STATUS_ERROR_INVALID_ARGUMENT_COMPATIBILITY,
+         AMD_DBGAPI_STATUS_ERROR_MEMORY_ACCESS);
+  TRACE_END (make_ref (param_out (value_size)),
+             make_hex (make_ref (param_out (lane_mask))));
+}
+
 amd_dbgapi_status_t AMD_DBGAPI
 amd_dbgapi_write_memory (amd_dbgapi_process_id_t process_id,
                          amd_dbgapi_wave_id_t wave_id,
@@ -1267,8 +1394,11 @@ amd_dbgapi_write_memory (amd_dbgapi_process_id_t process_id,
     make_hex (make_ref (param_in (value), value_size ? *value_size : 0)));
   TRY
   {
-    xfer_memory (process_id, wave_id, lane_id, address_space_id,
-                 segment_address, value_size, nullptr, value);
+    if (amd_dbgapi_status_t status
+        = xfer_memory (process_id, wave_id, lane_id, address_space_id,
+                       segment_address, value_size, nullptr, value);
+        status != AMD_DBGAPI_STATUS_SUCCESS)
+      return status;
   }
   CATCH (AMD_DBGAPI_STATUS_ERROR_NOT_INITIALIZED,
          AMD_DBGAPI_STATUS_ERROR_INVALID_PROCESS_ID,
@@ -396,15 +396,29 @@ public:
   /* Create cache lines if not already valid, and immediately fill them in.  */
   void prefetch (amd_dbgapi_global_address_t address, amd_dbgapi_size_t size);
 
+  /* Prefetch all the RANGES, merging the ranges separated by at most MAX_GAP
+     bytes so that they are filled in with a single memory access.  */
+  void
+  prefetch (std::vector<std::pair<amd_dbgapi_global_address_t /* address */,
+                                  amd_dbgapi_size_t /* size */>>
+              ranges,
+            amd_dbgapi_size_t max_gap = 0);
+
   /* Discard all cache lines in the specified range.  If FORCE_DISCARD
      is true, dirty lines are silently dropped.  Otherwise it is an error to
      discarded dirty cache lines.  */
   void discard (amd_dbgapi_global_address_t address = 0,
                 amd_dbgapi_size_t size = -1, bool force_discard = false);
 
-  /* Write dirty lines back to memory.  */
+  /* Write dirty lines back to memory.  Contiguous cache lines are written
+     with a single memory access.  If MAX_GAP is not 0, up to MAX_GAP bytes of
+     clean cache lines separating dirty lines are written back as well so that
+     the dirty lines can be grouped.  This is only correct if the memory cannot
+     be modified by others while it is cached, for example the context save
+     area of a suspended queue.  */
   void write_back (amd_dbgapi_global_address_t address = 0,
-                   amd_dbgapi_size_t size = -1);
+                   amd_dbgapi_size_t size = -1,
+                   amd_dbgapi_size_t max_gap = 0);
 
   [[nodiscard]] size_t read_global_memory (amd_dbgapi_global_address_t address,
                                            void *buffer, size_t size)
@@ -26,10 +26,12 @@
 #include "utils.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cinttypes>
 #include <fstream>
 #include <iomanip>
 #include <limits>
+#include <map>
 #include <optional>
 #include <sstream>
 #include <type_traits>
@@ -241,6 +243,14 @@ public:
     [] (auto &&...) {}(read, write);
     return AMD_DBGAPI_STATUS_ERROR_MEMORY_ACCESS;
   }
+
+  amd_dbgapi_status_t
+  read_global_memory_from_worker (amd_dbgapi_global_address_t /* address  */,
+                                  void * /* read  */,
+                                  size_t * /* size  */) const override
+  {
+    return AMD_DBGAPI_STATUS_ERROR_MEMORY_ACCESS;
+  }
 };
 
 /* OS Driver implementation for the Linux ROCm stack using KFD.  */
@@ -516,7 +526,7 @@ struct kfd_note_header_t
   uint32_t queue_entry_size;
 };
 
-class kfd_core_driver_t final : public kfd_driver_base_t
+class kfd_core_driver_t : public kfd_driver_base_t
 {
 public:
   kfd_core_driver_t (const amd_dbgapi_core_state_data_t &core_state);
@@ -727,6 +737,85 @@ kfd_core_driver_t::enable_debug (os_exception_mask_t exceptions_reported,
   TRACE_DRIVER_END (make_ref (param_out (runtime_info)));
 }
 
+/* A driver for the GPU snapshots written by process_t::write_gpu_snapshot.
+   The queues and agents are simulated from the core state note like for a
+   core dump, and the global memory is read from the snapshot's memory
+   records.  */
+
+class kfd_snapshot_driver_t final : public kfd_core_driver_t
+{
+private:
+  file_desc_t const m_fd;
+
+  /* The memory records of the snapshot, indexed by their address.  */
+  std::map<amd_dbgapi_global_address_t, gpu_snapshot_index_entry_t> const
+    m_memory_records;
+
+public:
+  kfd_snapshot_driver_t (
+    const amd_dbgapi_core_state_data_t &core_state, file_desc_t fd,
+    std::map<amd_dbgapi_global_address_t, gpu_snapshot_index_entry_t>
+      memory_records)
+    : kfd_core_driver_t (core_state), m_fd (fd),
+      m_memory_records (std::move (memory_records))
+  {
+  }
+
+  ~kfd_snapshot_driver_t () override { ::close (m_fd); }
+
+  amd_dbgapi_status_t
+  xfer_global_memory_partial (amd_dbgapi_global_address_t address, void *read,
+                              const void *write, size_t *size) const override;
+};
+
+amd_dbgapi_status_t
+kfd_snapshot_driver_t::xfer_global_memory_partial (
+  amd_dbgapi_global_address_t address, void *read, const void *write,
+  size_t *size) const
+{
+  dbgapi_assert (!read != !write && "either read or write buffer");
+
+  /* The snapshot is read-only.  */
+  if (write != nullptr)
+    return AMD_DBGAPI_STATUS_ERROR_MEMORY_ACCESS;
+
+  size_t xfer_size = 0;
+  while (xfer_size < *size)
+    {
+      amd_dbgapi_global_address_t xfer_address = address + xfer_size;
+
+      /* Find the memory record containing XFER_ADDRESS.  Consecutive records
+         may split a contiguous memory region.  */
+      auto it = m_memory_records.upper_bound (xfer_address);
+      if (it == m_memory_records.begin ())
+        break;
+
+      const auto &[record_address, entry] = *std::prev (it);
+      if (xfer_address >= record_address + entry.record.size)
+        break;
+
+      size_t request_size
+        = std::min (*size - xfer_size,
+                    record_address + entry.record.size - xfer_address);
+      void *buffer = static_cast<std::byte *> (read) + xfer_size;
+
+      if (entry.record.kind == gpu_snapshot_record_kind_t::zero_memory)
+        memset (buffer, '\0', request_size);
+      else if (pread (m_fd, buffer, request_size,
+                      entry.offset + xfer_address - record_address)
+               != static_cast<ssize_t> (request_size))
+        break;
+
+      xfer_size += request_size;
+    }
+
+  if (xfer_size == 0 && *size != 0)
+    return AMD_DBGAPI_STATUS_ERROR_MEMORY_ACCESS;
+
+  *size = xfer_size;
+  return AMD_DBGAPI_STATUS_SUCCESS;
+}
+
 class kfd_driver_t final : public kfd_driver_base_t
 {
 private:
@@ -735,10 +824,12 @@ private:
 
   std::optional<file_desc_t> m_proc_mem_fd{};
 
-  mutable size_t m_read_request_count{};
-  mutable size_t m_write_request_count{};
-  mutable size_t m_bytes_read{};
-  mutable size_t m_bytes_written{};
+  /* The memory transfers may be done concurrently by a process' prefetch
+     worker thread.  */
+  mutable std::atomic<size_t> m_read_request_count{};
+  mutable std::atomic<size_t> m_write_request_count{};
+  mutable std::atomic<size_t> m_bytes_read{};
+  mutable std::atomic<size_t> m_bytes_written{};
 
   static void open_kfd ();
   static void close_kfd ();
@@ -777,9 +868,9 @@ public:
 
     log_info ("kfd_driver_t statistics (pid %d): "
               "%ld reads (%s), %ld writes (%s)",
-              m_os_pid.value (), m_read_request_count,
+              m_os_pid.value (), m_read_request_count.load (),
               utils::human_readable_size (m_bytes_read).c_str (),
-              m_write_request_count,
+              m_write_request_count.load (),
               utils::human_readable_size (m_bytes_written).c_str ());
 
     if (m_proc_mem_fd)
@@ -869,6 +960,10 @@ public:
   amd_dbgapi_status_t
   xfer_global_memory_partial (amd_dbgapi_global_address_t address, void *read,
                               const void *write, size_t *size) const override;
+
+  amd_dbgapi_status_t
+  read_global_memory_from_worker (amd_dbgapi_global_address_t address,
+                                  void *read, size_t *size) const override;
 };
 
 size_t kfd_driver_t::s_kfd_open_count{ 0 };
@@ -1654,6 +1749,24 @@ kfd_driver_t::xfer_global_memory_partial (amd_dbgapi_global_address_t address,
   return AMD_DBGAPI_STATUS_SUCCESS;
 }
 
+amd_dbgapi_status_t
+kfd_driver_t::read_global_memory_from_worker (
+  amd_dbgapi_global_address_t address, void *read, size_t *size) const
+{
+  if (!m_proc_mem_fd)
+    return AMD_DBGAPI_STATUS_ERROR_MEMORY_ACCESS;
+
+  ssize_t ret = pread (*m_proc_mem_fd, read, *size, address);
+
+  if (ret == 0 && *size != 0)
+    return AMD_DBGAPI_STATUS_ERROR_PROCESS_EXITED;
+  else if (ret < 0)
+    return AMD_DBGAPI_STATUS_ERROR_MEMORY_ACCESS;
+
+  *size = ret;
+  return AMD_DBGAPI_STATUS_SUCCESS;
+}
+
 std::unique_ptr<os_driver_t>
 os_driver_t::create_driver (std::optional<amd_dbgapi_os_process_id_t> os_pid)
 {
@@ -1698,6 +1811,121 @@ os_driver_t::create_driver (const amd_dbgapi_core_state_data_t &core_state)
   return std::make_unique<null_driver_t> (std::nullopt);
 }
 
+std::unique_ptr<os_driver_t>
+os_driver_t::create_snapshot_driver (file_desc_t gpu_snapshot_fd)
+{
+  auto os_driver = [gpu_snapshot_fd] () -> std::unique_ptr<os_driver_t>
+  {
+    file_desc_t fd = ::dup (gpu_snapshot_fd);
+    if (fd == -1)
+      {
+        warning ("Cannot open the GPU snapshot: %s", strerror (errno));
+        return nullptr;
+      }
+
+    auto close_fd = utils::make_scope_exit ([fd] () { ::close (fd); });
+
+    auto read_at = [fd] (uint64_t offset, void *buffer, size_t size)
+    {
+      return pread (fd, buffer, size, offset)
+             == static_cast<ssize_t> (size);
+    };
+
+    gpu_snapshot_header_t header;
+    if (!read_at (0, &header, sizeof (header))
+        || memcmp (header.magic, gpu_snapshot_magic, sizeof (header.magic))
+        || header.version != gpu_snapshot_version)
+      {
+        warning ("Invalid GPU snapshot header");
+        return nullptr;
+      }
+
+    /* The index is found using the footer at the end of the file.  */
+    off_t file_size = lseek (fd, 0, SEEK_END);
+    gpu_snapshot_footer_t footer;
+    if (file_size < static_cast<off_t> (sizeof (header) + sizeof (footer))
+        || !read_at (file_size - sizeof (footer), &footer, sizeof (footer))
+        || memcmp (footer.magic, gpu_snapshot_magic, sizeof (footer.magic)))
+      {
+        warning ("Invalid GPU snapshot footer, the snapshot may be "
+                 "truncated or not seekable");
+        return nullptr;
+      }
+
+    gpu_snapshot_record_t index_record;
+    if (!read_at (footer.index_offset, &index_record, sizeof (index_record))
+        || index_record.kind != gpu_snapshot_record_kind_t::index
+        || index_record.size % sizeof (gpu_snapshot_index_entry_t))
+      {
+        warning ("Invalid GPU snapshot index");
+        return nullptr;
+      }
+
+    std::vector<gpu_snapshot_index_entry_t> index (
+      index_record.size / sizeof (gpu_snapshot_index_entry_t));
+    if (!read_at (footer.index_offset + sizeof (index_record), index.data (),
+                  index_record.size))
+      {
+        warning ("Invalid GPU snapshot index");
+        return nullptr;
+      }
+
+    std::vector<std::byte> note;
+    std::map<amd_dbgapi_global_address_t, gpu_snapshot_index_entry_t>
+      memory_records;
+
+    for (auto &&entry : index)
+      switch (entry.record.kind)
+        {
+        case gpu_snapshot_record_kind_t::core_state_note:
+          note.resize (entry.record.size);
+          if (!read_at (entry.offset, note.data (), note.size ()))
+            {
+              warning ("Invalid GPU snapshot core state note");
+              return nullptr;
+            }
+          break;
+
+        case gpu_snapshot_record_kind_t::memory:
+        case gpu_snapshot_record_kind_t::zero_memory:
+          memory_records.emplace (entry.record.address, entry);
+          break;
+
+        default:
+          warning ("Invalid GPU snapshot record kind %#x",
+                   static_cast<uint32_t> (entry.record.kind));
+          return nullptr;
+        }
+
+    amd_dbgapi_core_state_data_t core_state{ header.endianness, note.size (),
+                                             note.data () };
+
+    note_reader reader{ core_state };
+    if (reader.read<amdgpu_core_note_version_t> ()
+        != amdgpu_core_note_version_t::kfd_note)
+      {
+        warning ("Invalid GPU snapshot core state note");
+        return nullptr;
+      }
+
+    /* The driver now owns the file descriptor.  */
+    close_fd.release ();
+    auto snapshot_driver = std::make_unique<kfd_snapshot_driver_t> (
+      core_state, fd, std::move (memory_records));
+
+    if (!snapshot_driver->is_valid ())
+      return nullptr;
+
+    return snapshot_driver;
+  }();
+
+  if (os_driver != nullptr)
+    return os_driver;
+
+  /* Fallback to the null_driver if the snapshot could not be opened.  */
+  return std::make_unique<null_driver_t> (std::nullopt);
+}
+
 template <>
 std::string
 to_string (os_wave_launch_mode_t mode)
@@ -365,6 +365,58 @@ enum class os_wave_launch_mode_t : uint32_t
   disable = 4,     /* Disable launching any new waves.  */
 };
 
+/* A GPU snapshot holds the core state note and the memory regions needed to
+   debug the GPU side of a process.  It is written sequentially: a header,
+   then records each made of a gpu_snapshot_record_t followed by its data
+   padded to a multiple of 8 bytes, then an index record listing all the
+   other records with the file offset of their data, and finally a footer
+   holding the file offset of the index record.  */
+
+constexpr char gpu_snapshot_magic[8]
+  = { 'A', 'M', 'D', 'G', 'P', 'U', 'S', 'S' };
+constexpr uint32_t gpu_snapshot_version = 1;
+
+struct gpu_snapshot_header_t
+{
+  char magic[8];
+  uint32_t version;
+  amd_dbgapi_endianness_t endianness;
+};
+
+enum class gpu_snapshot_record_kind_t : uint32_t
+{
+  /* The content of the core state note.  */
+  core_state_note = 1,
+  /* The content of a memory region.  */
+  memory = 2,
+  /* A memory region only containing zeros.  The record has no data.  */
+  zero_memory = 3,
+  /* The index, an array of gpu_snapshot_index_entry_t.  */
+  index = 4
+};
+
+struct gpu_snapshot_record_t
+{
+  gpu_snapshot_record_kind_t kind;
+  uint32_t reserved;
+  amd_dbgapi_global_address_t address;
+  uint64_t size;
+};
+
+struct gpu_snapshot_index_entry_t
+{
+  gpu_snapshot_record_t record;
+  /* The file offset of the record's data.  */
+  uint64_t offset;
+};
+
+struct gpu_snapshot_footer_t
+{
+  /* The file offset of the index record.  */
+  uint64_t index_offset;
+  char magic[8];
+};
+
 class os_driver_t
 {
 protected:
@@ -388,6 +440,11 @@ public:
   static std::unique_ptr<os_driver_t>
   create_driver (const amd_dbgapi_core_state_data_t &core_state);
 
+  /* Create a driver for the GPU snapshot open on GPU_SNAPSHOT_FD.  The file
+     descriptor is duplicated.  */
+  static std::unique_ptr<os_driver_t>
+  create_snapshot_driver (file_desc_t gpu_snapshot_fd);
+
   virtual bool is_valid () const = 0;
 
   virtual amd_dbgapi_status_t check_version () const = 0;
@@ -464,9 +521,18 @@ public:
   virtual amd_dbgapi_status_t
   set_precise_alu_exceptions (bool enabled) const = 0;
 
+  /* Transfer global memory.  */
   virtual amd_dbgapi_status_t
   xfer_global_memory_partial (amd_dbgapi_global_address_t address, void *read,
                               const void *write, size_t *size) const = 0;
+
+  /* Read global memory from a process' prefetch worker thread.  This is the
+     only operation that may be called concurrently with the others, so it
+     does not log, assert, or update the transfer statistics: the caller
+     reports the returned status on the client thread.  */
+  virtual amd_dbgapi_status_t
+  read_global_memory_from_worker (amd_dbgapi_global_address_t address,
+                                  void *read, size_t *size) const = 0;
 };
 
 template <> std::string to_string (os_agent_info_t os_agent_info);
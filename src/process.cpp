@@ -36,6 +36,8 @@
 #include "wave.h"
 
 #include <algorithm>
+#include <cerrno>
+#include <chrono>
 #include <exception>
 #include <iterator>
 #include <limits>
@@ -46,7 +48,9 @@
 #include <utility>
 #include <vector>
 
+#include <fcntl.h>
 #include <link.h>
+#include <unistd.h>
 
 namespace amd::dbgapi
 {
@@ -74,10 +78,13 @@ process_t::process_t (amd_dbgapi_process_id_t process_id,
           status = detail::process_callbacks.xfer_global_memory (
             m_client_process_id, address, &size, read, write);
 
+        /* An inaccessible first byte is reported as a 0 bytes transfer rather
+           than by raising an exception, as callers routinely probe memory
+           that may not be mapped.  */
         if (status == AMD_DBGAPI_STATUS_ERROR_PROCESS_EXITED)
           throw process_exited_exception_t (*this);
         else if (status == AMD_DBGAPI_STATUS_ERROR_MEMORY_ACCESS)
-          throw memory_access_error_t (address_space_t::global (), address);
+          return size_t{ 0 };
         else if (status != AMD_DBGAPI_STATUS_SUCCESS)
           fatal_error ("xfer_global_memory_partial failed (%s)",
                        to_cstring (status));
@@ -115,8 +122,17 @@ process_t::process_t (amd_dbgapi_process_id_t process_id,
       status
         = client_process_get_info (AMD_DBGAPI_CLIENT_PROCESS_INFO_CORE_STATE,
                                    sizeof (core_state), &core_state);
+
+      /* If there is no core state, the process may be created from a GPU
+         snapshot instead.  */
+      file_desc_t gpu_snapshot_fd;
       if (status == AMD_DBGAPI_STATUS_SUCCESS)
         m_os_driver = os_driver_t::create_driver (core_state);
+      else if (client_process_get_info (
+                 AMD_DBGAPI_CLIENT_PROCESS_INFO_GPU_SNAPSHOT,
+                 sizeof (gpu_snapshot_fd), &gpu_snapshot_fd)
+               == AMD_DBGAPI_STATUS_SUCCESS)
+        m_os_driver = os_driver_t::create_snapshot_driver (gpu_snapshot_fd);
       else
         m_os_driver = os_driver_t::create_driver (std::nullopt);
     }
@@ -180,7 +196,9 @@ process_t::detach ()
           std::vector<queue_t *> queues;
 
           /* Keep the queues suspended, the OS driver will resume all queues
-             after disabling the debug mode.  */
+             after disabling the debug mode.  A queue resumed while the debug
+             mode is still enabled could report new exceptions that would
+             never be processed.  */
           set_forward_progress_needed (false);
 
           /* Return precise memory reporting to its default off state.  */
@@ -208,38 +226,56 @@ process_t::detach ()
           for (auto &&watchpoint : range<watchpoint_t> ())
             remove_watchpoint (watchpoint);
 
-          for (auto &&wave : range<wave_t> ())
+          /* Suspending the queues updates their waves, so only iterate the
+             waves once all the queues are suspended.  The waves are updated
+             one queue at a time, and the queue's context save area is then
+             written back in a single pass, instead of leaving the dirty lines
+             of all the queues to the final write back.  */
+          for (auto &&queue : range<queue_t> ())
             {
-              /* If the wave was displaced stepping, cancel the operation now
-                 while the queue is suspended (it may write registers).  */
-              if (wave.displaced_stepping () != nullptr)
+              for (auto &&wave : range<wave_t> ())
                 {
-                  wave.set_state (AMD_DBGAPI_WAVE_STATE_STOP);
-                  wave.displaced_stepping_complete ();
+                  if (&wave.queue () != &queue)
+                    continue;
+
+                  /* If the wave was displaced stepping, cancel the operation
+                     now while the queue is suspended (it may write
+                     registers).  */
+                  if (wave.displaced_stepping () != nullptr)
+                    {
+                      wave.set_state (AMD_DBGAPI_WAVE_STATE_STOP);
+                      wave.displaced_stepping_complete ();
+                    }
+
+                  /* Invalidate the wave_id.  */
+                  wave.write_register (amdgpu_regnum_t::wave_id,
+                                       wave_t::undefined);
+
+                  /* Resume the wave if it is single-stepping, or if it is
+                     stopped because of a debug event (completed single-step,
+                     breakpoint, watchpoint).  The wave is not resumed if it
+                     is halted because of pending exceptions.  */
+                  if ((wave.state () == AMD_DBGAPI_WAVE_STATE_SINGLE_STEP)
+                      || (wave.state () == AMD_DBGAPI_WAVE_STATE_STOP
+                          && !(wave.stop_reason ()
+                               & ~wave_t::resumable_stop_reason_mask)))
+                    {
+                      wave.set_state (AMD_DBGAPI_WAVE_STATE_RUN);
+                    }
                 }
 
-              /* Invalidate the wave_id.  */
-              wave.write_register (amdgpu_regnum_t::wave_id,
-                                   wave_t::undefined);
-
-              /* Resume the wave if it is single-stepping, or if it is stopped
-                 because of a debug event (completed single-step, breakpoint,
-                 watchpoint).  The wave is not resumed if it is halted because
-                 of pending exceptions.  */
-              if ((wave.state () == AMD_DBGAPI_WAVE_STATE_SINGLE_STEP)
-                  || (wave.state () == AMD_DBGAPI_WAVE_STATE_STOP
-                      && !(wave.stop_reason ()
-                           & ~wave_t::resumable_stop_reason_mask)))
-                {
-                  wave.set_state (AMD_DBGAPI_WAVE_STATE_RUN);
-                }
+              if (queue.is_suspended ())
+                queue.write_back_context_save_area ();
             }
         }
 
-      /* Write back the entire memory cache to commit our changes to the
-         waves' context save area memory.  */
+      /* Apply the pc writes staged in the queues left suspended, then write
+         back the entire memory cache to commit our changes to the waves'
+         context save area memory.  */
       try
         {
+          flush_pc_writes ();
+
           memory_cache ().write_back (0, -1);
         }
       catch (const memory_access_error_t &)
@@ -505,6 +541,22 @@ process_t::set_precise_memory (bool enabled)
                  to_cstring (status));
 }
 
+void
+process_t::set_event_processing (amd_dbgapi_event_processing_t processing)
+{
+  if (processing == AMD_DBGAPI_EVENT_PROCESSING_PIPELINED)
+    {
+      if (m_prefetch_worker == nullptr)
+        m_prefetch_worker = std::make_unique<utils::worker_thread_t> ();
+    }
+  else
+    {
+      /* All the jobs submitted to the worker have completed when
+         suspend_queues returns, so it can be destroyed at any time.  */
+      m_prefetch_worker.reset ();
+    }
+}
+
 void
 process_t::set_precise_alu_exceptions (bool enabled)
 {
@@ -817,6 +869,35 @@ process_t::watchpoint_shared_kind () const
   return kind;
 }
 
+void
+process_t::set_stop_reason_action (amd_dbgapi_wave_stop_reasons_t stop_reasons,
+                                   amd_dbgapi_stop_reason_action_t action)
+{
+  m_resume_stop_reasons &= ~stop_reasons;
+  m_terminate_stop_reasons &= ~stop_reasons;
+
+  if (action == AMD_DBGAPI_STOP_REASON_ACTION_RESUME)
+    m_resume_stop_reasons |= stop_reasons;
+  else if (action == AMD_DBGAPI_STOP_REASON_ACTION_TERMINATE)
+    m_terminate_stop_reasons |= stop_reasons;
+}
+
+amd_dbgapi_stop_reason_action_t
+process_t::stop_reason_action (
+  amd_dbgapi_wave_stop_reasons_t stop_reasons) const
+{
+  /* A stop is reported if any of its stop reasons is reported.  */
+  if (stop_reasons == AMD_DBGAPI_WAVE_STOP_REASON_NONE
+      || (stop_reasons & ~(m_resume_stop_reasons | m_terminate_stop_reasons))
+           != AMD_DBGAPI_WAVE_STOP_REASON_NONE)
+    return AMD_DBGAPI_STOP_REASON_ACTION_REPORT;
+
+  return (stop_reasons & m_terminate_stop_reasons)
+             != AMD_DBGAPI_WAVE_STOP_REASON_NONE
+           ? AMD_DBGAPI_STOP_REASON_ACTION_TERMINATE
+           : AMD_DBGAPI_STOP_REASON_ACTION_RESUME;
+}
+
 size_t
 process_t::suspend_queues (const std::vector<queue_t *> &queues,
                            const char *reason) const
@@ -907,6 +988,23 @@ process_t::suspend_queues (const std::vector<queue_t *> &queues,
         }
     }
 
+  /* In the pipelined event processing mode, the context save areas of all
+     the queues are read in the background while the waves of the first
+     queues are decoded by set_state below.  The prefetched context save
+     areas must not outlive this suspension, even if an exception is raised,
+     as they are only valid until the queues are resumed.  */
+  if (m_prefetch_worker != nullptr)
+    for (queue_t *queue : queues)
+      if (queue->is_valid () && !queue->is_all_stopped ())
+        queue->prefetch_context_save_area (*m_prefetch_worker);
+
+  auto discard_prefetches = utils::make_scope_exit (
+    [&] ()
+    {
+      for (queue_t *queue : queues)
+        queue->discard_context_save_area_prefetch ();
+    });
+
   /* The queue state is published last so that listeners may
      act on the state right after the queue is unscheduled.  */
   for (queue_t *queue : queues)
@@ -923,7 +1021,7 @@ process_t::suspend_queues (const std::vector<queue_t *> &queues,
 
 size_t
 process_t::resume_queues (const std::vector<queue_t *> &queues,
-                          const char *reason) const
+                          const char *reason)
 {
   dbgapi_assert (!is_frozen ());
   if (queues.empty ())
@@ -963,6 +1061,10 @@ process_t::resume_queues (const std::vector<queue_t *> &queues,
       queue->set_state (queue_t::state_t::running);
     }
 
+  /* The exceptions raised by the waves of the queues must reach the runtime
+     before the queues are resumed.  */
+  send_queued_exceptions (queues);
+
   auto os_queue_id_to_id = [this] (os_queue_id_t os_queue_id)
   {
     const queue_t *queue = find_if (
@@ -1328,12 +1430,66 @@ process_t::update_code_objects ()
        code_object_it != range<code_object_t> ().end ();)
     {
       if (code_object_it->mark () < code_object_mark)
-        code_object_it = destroy (code_object_it);
+        {
+          code_object_it = destroy (code_object_it);
+          m_kernel_descriptors.clear ();
+        }
       else
         ++code_object_it;
     }
 }
 
+std::shared_ptr<const architecture_t::kernel_descriptor_t>
+process_t::kernel_descriptor (const architecture_t &architecture,
+                              amd_dbgapi_global_address_t kernel_object)
+{
+  auto [it, inserted] = m_kernel_descriptors.try_emplace (kernel_object);
+
+  if (inserted)
+    {
+      try
+        {
+          it->second
+            = architecture.make_kernel_descriptor (*this, kernel_object);
+        }
+      catch (...)
+        {
+          m_kernel_descriptors.erase (it);
+          throw;
+        }
+    }
+
+  dbgapi_assert (it->second->address () == kernel_object);
+  return it->second;
+}
+
+namespace detail
+{
+
+/* Log the time spent in each phase of a lengthy operation.  */
+class phase_timer_t
+{
+private:
+  const char *const m_operation;
+  std::chrono::steady_clock::time_point m_phase_start{
+    std::chrono::steady_clock::now ()
+  };
+
+public:
+  phase_timer_t (const char *operation) : m_operation (operation) {}
+
+  void end_phase (const char *phase)
+  {
+    auto now = std::chrono::steady_clock::now ();
+    log_info ("%s: %s took %.3f ms", m_operation, phase,
+              std::chrono::duration<double, std::milli> (now - m_phase_start)
+                .count ());
+    m_phase_start = now;
+  }
+};
+
+} /* namespace detail */
+
 void
 process_t::runtime_enable (os_runtime_info_t runtime_info)
 {
@@ -1515,12 +1671,16 @@ process_t::runtime_enable (os_runtime_info_t runtime_info)
          .is_inserted ())
     return;
 
+  detail::phase_timer_t timer ("runtime enable");
+
   update_queues ();
+  timer.end_phase ("update queues");
 
   if (!is_flag_set (flag_t::runtime_enable_during_attach) && count<queue_t> ())
     fatal_error ("no queue can exist before the runtime is enabled");
 
   update_code_objects ();
+  timer.end_phase ("update code objects");
 
   status = os_driver ().set_wave_launch_mode (m_wave_launch_mode);
   if (status != AMD_DBGAPI_STATUS_SUCCESS
@@ -1569,14 +1729,32 @@ process_t::runtime_enable (os_runtime_info_t runtime_info)
                      to_cstring (id ()), to_cstring (status));
     }
 
+  timer.end_phase ("configure wave launch");
+
   std::vector<queue_t *> queues;
   for (auto &&queue : range<queue_t> ())
     queues.emplace_back (&queue);
 
   /* Suspend the newly created queues to update the waves, then resume them.
-     We could have attached to the process while wavefronts were executing.  */
-  suspend_queues (queues, "attach to process");
-  resume_queues (queues, "attach to process");
+     We could have attached to the process while wavefronts were executing.
+     The queues are processed in small batches, and each batch is resumed as
+     soon as its waves are updated, so that the queues are not all stalled
+     while the waves of a large process are decoded.  */
+  for (size_t first = 0; first < queues.size ();
+       first += attach_queue_batch_size)
+    {
+      std::vector<queue_t *> batch (
+        queues.begin () + first,
+        queues.begin ()
+          + std::min (first + attach_queue_batch_size, queues.size ()));
+
+      suspend_queues (batch, "attach to process");
+      resume_queues (batch, "attach to process");
+    }
+
+  if (!queues.empty ())
+    timer.end_phase (
+      string_printf ("update waves of %zu queues", queues.size ()).c_str ());
 
   clear_flag (flag_t::runtime_enable_during_attach);
   set_flag (flag_t::spi_ttmps_setup_enabled);
@@ -1595,6 +1773,8 @@ process_t::attach ()
   if (os_driver ().check_version () != AMD_DBGAPI_STATUS_SUCCESS)
     throw api_error_t (AMD_DBGAPI_STATUS_ERROR_RESTRICTION);
 
+  detail::phase_timer_t timer ("attach");
+
   os_runtime_info_t runtime_info{};
   if (auto status = os_driver ().enable_debug (
         os_exception_mask_t::process_runtime,
@@ -1617,9 +1797,12 @@ process_t::attach ()
         fatal_error ("disable_debug failed (%s)", to_cstring (status));
     });
 
+  timer.end_phase ("enable debug");
+
   /* Update the agent now, regardless of the runtime state, so that agents can
      be reported as soon as the process is attached.  */
   update_agents ();
+  timer.end_phase ("update agents");
 
   if (runtime_info.runtime_state != os_runtime_state_t::disabled)
     {
@@ -1628,6 +1811,7 @@ process_t::attach ()
 
       set_flag (flag_t::runtime_enable_during_attach);
       runtime_enable (runtime_info);
+      timer.end_phase ("enable runtime");
     }
 
   disable_debug.release ();
@@ -1649,6 +1833,10 @@ process_t::freeze ()
       queues.emplace_back (&queue);
   suspend_queues (queues, "process freeze");
 
+  /* The pc writes staged by parking and unparking waves are otherwise only
+     applied when the queues are resumed.  */
+  flush_pc_writes ();
+
   /* The freeze operation is used before creating a core dump of the current
      process.  Ensure that any modification done to memory so far is flushed
      to the inferior's memory so it can be captured in the core dump.  */
@@ -1657,12 +1845,249 @@ process_t::freeze ()
   m_frozen = true;
 }
 
+void
+process_t::flush_pc_writes ()
+{
+  for (auto &&queue : range<queue_t> ())
+    if (queue.is_suspended ())
+      queue.flush_pc_writes ();
+}
+
 void
 process_t::unfreeze ()
 {
   m_frozen = false;
 }
 
+namespace detail
+{
+
+/* Return the memory region holding the image of a code object loaded from
+   memory, if URI is a memory URI (memory://PID#offset=OFFSET&size=SIZE).  */
+std::optional<std::pair<amd_dbgapi_global_address_t, amd_dbgapi_size_t>>
+memory_uri_region (const std::string &uri)
+{
+  constexpr char memory_scheme[] = "memory://";
+  if (uri.compare (0, sizeof (memory_scheme) - 1, memory_scheme) != 0)
+    return std::nullopt;
+
+  auto offset_pos = uri.find ("#offset=");
+  auto size_pos = uri.find ("&size=");
+  if (offset_pos == std::string::npos || size_pos == std::string::npos)
+    return std::nullopt;
+
+  try
+    {
+      return std::make_pair (
+        std::stoull (uri.substr (offset_pos + sizeof ("#offset=") - 1),
+                     nullptr, 0),
+        std::stoull (uri.substr (size_pos + sizeof ("&size=") - 1), nullptr,
+                     0));
+    }
+  catch (const std::exception &)
+    {
+      return std::nullopt;
+    }
+}
+
+} /* namespace detail */
+
+void
+process_t::write_gpu_snapshot (file_desc_t fd)
+{
+  /* Size of the memory records.  Regions only containing zeros are written
+     as records without data, so smaller records make the snapshot smaller.
+   */
+  constexpr amd_dbgapi_size_t memory_record_size = 64 * 1024;
+  /* Size of the instruction memory saved around each wave's pc.  */
+  constexpr amd_dbgapi_size_t pc_region_size = 4096;
+  /* Size of an AMDGPU kernel descriptor.  */
+  constexpr amd_dbgapi_size_t kernel_descriptor_size = 64;
+
+  dbgapi_assert (is_frozen ());
+
+  /* Waves may have been parked or unparked since the process was frozen.  */
+  flush_pc_writes ();
+
+  /* The core state note is the same as in a core dump.  This also checks
+     that a reliable snapshot can be created.  */
+  amd_dbgapi_core_state_data_t core_state{};
+  get_info (AMD_DBGAPI_PROCESS_INFO_CORE_STATE, sizeof (core_state),
+            &core_state);
+  auto core_state_cleaner = utils::make_scope_exit (
+    [&core_state] ()
+    { deallocate_memory (const_cast<void *> (core_state.data)); });
+
+  std::vector<std::pair<amd_dbgapi_global_address_t, amd_dbgapi_size_t>>
+    regions;
+
+  /* The code object list read by update_code_objects, and the images of the
+     code objects loaded from memory.  */
+  if (m_runtime_state == AMD_DBGAPI_RUNTIME_STATE_LOADED_SUCCESS)
+    {
+      regions.emplace_back (m_runtime_info.r_debug, sizeof (r_debug));
+
+      amd_dbgapi_global_address_t link_map_address;
+      read_global_memory (m_runtime_info.r_debug + offsetof (r_debug, r_map),
+                          &link_map_address);
+
+      while (link_map_address)
+        {
+          regions.emplace_back (link_map_address, sizeof (link_map));
+
+          amd_dbgapi_global_address_t l_name_address;
+          read_global_memory (link_map_address + offsetof (link_map, l_name),
+                              &l_name_address);
+
+          std::string uri;
+          read_string (l_name_address, &uri, -1);
+          regions.emplace_back (l_name_address, uri.size () + 1);
+
+          if (auto image = detail::memory_uri_region (uri))
+            regions.emplace_back (*image);
+
+          read_global_memory (link_map_address + offsetof (link_map, l_next),
+                              &link_map_address);
+        }
+    }
+
+  for (auto &&queue : range<queue_t> ())
+    for (auto &&region : queue.memory_regions ())
+      regions.emplace_back (region);
+
+  for (auto &&dispatch : range<dispatch_t> ())
+    regions.emplace_back (dispatch.kernel_descriptor ().address (),
+                          kernel_descriptor_size);
+
+  for (auto &&wave : range<wave_t> ())
+    {
+      regions.emplace_back (utils::align_down (wave.pc (), pc_region_size),
+                            pc_region_size);
+
+      if (wave.state () == AMD_DBGAPI_WAVE_STATE_STOP)
+        regions.emplace_back (wave.scratch_memory_region ());
+    }
+
+  /* Sort the regions and merge the overlapping ones.  The regions are
+     extended to whole cache lines, as the memory cache reads whole cache
+     lines.  */
+  for (auto &&[address, size] : regions)
+    {
+      auto end = utils::align_up (address + size,
+                                  memory_cache_t::cache_line_size);
+      address = utils::align_down (address, memory_cache_t::cache_line_size);
+      size = end - address;
+    }
+
+  std::sort (regions.begin (), regions.end ());
+
+  std::vector<std::pair<amd_dbgapi_global_address_t, amd_dbgapi_size_t>>
+    merged_regions;
+  for (auto &&[address, size] : regions)
+    {
+      if (size == 0)
+        continue;
+
+      if (!merged_regions.empty ()
+          && address <= merged_regions.back ().first
+                          + merged_regions.back ().second)
+        {
+          auto &[last_address, last_size] = merged_regions.back ();
+          last_size = std::max (last_address + last_size, address + size)
+                      - last_address;
+        }
+      else
+        merged_regions.emplace_back (address, size);
+    }
+
+  /* Write the snapshot.  */
+  uint64_t offset = 0;
+  auto write_bytes = [fd, &offset] (const void *buffer, size_t size)
+  {
+    static constexpr std::byte padding[8]{};
+    const size_t padded_size = utils::align_up (size, sizeof (padding));
+
+    for (size_t written = 0; written < padded_size;)
+      {
+        const std::byte *bytes
+          = written < size ? static_cast<const std::byte *> (buffer) + written
+                           : padding;
+        size_t request_size
+          = written < size ? size - written : padded_size - written;
+
+        ssize_t ret = ::write (fd, bytes, request_size);
+        if (ret == -1 && errno == EINTR)
+          continue;
+        if (ret <= 0)
+          throw api_error_t (AMD_DBGAPI_STATUS_ERROR);
+
+        written += ret;
+      }
+
+    offset += padded_size;
+  };
+
+  std::vector<gpu_snapshot_index_entry_t> index;
+  auto write_record
+    = [&] (gpu_snapshot_record_kind_t kind,
+           amd_dbgapi_global_address_t address, const void *data, size_t size)
+  {
+    gpu_snapshot_record_t record{ kind, 0, address, size };
+    write_bytes (&record, sizeof (record));
+    index.push_back ({ record, offset });
+
+    if (data != nullptr)
+      write_bytes (data, size);
+  };
+
+  gpu_snapshot_header_t header{};
+  std::copy (std::begin (gpu_snapshot_magic), std::end (gpu_snapshot_magic),
+             std::begin (header.magic));
+  header.version = gpu_snapshot_version;
+  header.endianness = core_state.endianness;
+  write_bytes (&header, sizeof (header));
+
+  write_record (gpu_snapshot_record_kind_t::core_state_note, 0,
+                core_state.data, core_state.size);
+
+  auto buffer = std::make_unique<std::byte[]> (memory_record_size);
+  for (auto &&[region_address, region_size] : merged_regions)
+    for (amd_dbgapi_size_t region_offset = 0; region_offset < region_size;
+         region_offset += memory_record_size)
+      {
+        amd_dbgapi_global_address_t address = region_address + region_offset;
+        size_t size = read_global_memory_partial (
+          address, buffer.get (),
+          std::min (memory_record_size, region_size - region_offset));
+
+        /* Memory that cannot be read is not saved.  */
+        if (size == 0)
+          continue;
+
+        if (std::all_of (buffer.get (), buffer.get () + size,
+                         [] (std::byte b) { return b == std::byte{ 0 }; }))
+          write_record (gpu_snapshot_record_kind_t::zero_memory, address,
+                        nullptr, size);
+        else
+          write_record (gpu_snapshot_record_kind_t::memory, address,
+                        buffer.get (), size);
+      }
+
+  gpu_snapshot_footer_t footer{ offset, {} };
+  std::copy (std::begin (gpu_snapshot_magic), std::end (gpu_snapshot_magic),
+             std::begin (footer.magic));
+
+  gpu_snapshot_record_t index_record{ gpu_snapshot_record_kind_t::index, 0, 0,
+                                      index.size ()
+                                        * sizeof (gpu_snapshot_index_entry_t) };
+  write_bytes (&index_record, sizeof (index_record));
+  write_bytes (index.data (), index_record.size);
+  write_bytes (&footer, sizeof (footer));
+
+  log_info ("wrote a %" PRIu64 " bytes GPU snapshot of %s (%zu records)",
+            offset, to_cstring (id ()), index.size ());
+}
+
 void
 process_t::get_info (amd_dbgapi_process_info_t query, size_t value_size,
                      void *value) const
@@ -1694,6 +2119,20 @@ process_t::get_info (amd_dbgapi_process_info_t query, size_t value_size,
       utils::get_info (value_size, value, *m_os_process_id);
       return;
 
+    case AMD_DBGAPI_PROCESS_INFO_STATISTICS:
+      /* The structure only grows at the end, so a client built against an
+         earlier version may request the counters it knows about.  */
+      if (!value)
+        throw api_error_t (AMD_DBGAPI_STATUS_ERROR_INVALID_ARGUMENT);
+
+      if (value_size == 0 || value_size > sizeof (m_statistics)
+          || value_size % sizeof (uint64_t) != 0)
+        throw api_error_t (
+          AMD_DBGAPI_STATUS_ERROR_INVALID_ARGUMENT_COMPATIBILITY);
+
+      memcpy (value, &m_statistics, value_size);
+      return;
+
     case AMD_DBGAPI_PROCESS_INFO_CORE_STATE:
       {
         if (!m_os_process_id)
@@ -1768,7 +2207,7 @@ process_t::get_info (amd_dbgapi_process_info_t query, size_t value_size,
 void
 process_t::enqueue_event (event_t &event)
 {
-  m_pending_events.emplace (&event);
+  m_pending_events.push (&event);
   event.set_state (event_t::state_t::queued);
 
   /* Notify the client that a new event is available.  */
@@ -1954,11 +2393,7 @@ event_t *
 process_t::next_pending_event ()
 {
   if (!m_pending_events.empty ())
-    {
-      event_t *event = m_pending_events.front ();
-      m_pending_events.pop ();
-      return event;
-    }
+    return m_pending_events.pop ();
 
   /* Value used to mark agents that have reported a new device memory
      violation exception.  */
@@ -2124,20 +2559,11 @@ process_t::next_pending_event ()
     if ((agent.exceptions () & os_exception_mask_t::device_memory_violation)
         != os_exception_mask_t::none)
       {
-        bool waves_with_memory_violation = false;
-
-        for (auto &&wave : range<wave_t> ())
-          if (wave.agent () == agent
-              && wave.state () == AMD_DBGAPI_WAVE_STATE_STOP
-              && (wave.stop_reason ()
-                  & AMD_DBGAPI_WAVE_STOP_REASON_MEMORY_VIOLATION))
-            {
-              /* Found a wave with a memory violation which has or will be
-                 reported to the debugger.  Defer reporting the device memory
-                 violation to the runtime until the wave is resumed.  */
-              waves_with_memory_violation = true;
-              break;
-            }
+        /* A wave with a memory violation has or will be reported to the
+           debugger.  Defer reporting the device memory violation to the
+           runtime until the wave is resumed.  */
+        const bool waves_with_memory_violation
+          = agent.memory_violation_wave_count () != 0;
 
         if (!waves_with_memory_violation
             && agent.mark () == new_device_memory_violation_mark)
@@ -2200,9 +2626,7 @@ process_t::next_pending_event ()
   if (m_pending_events.empty ())
     return nullptr;
 
-  event_t *event = m_pending_events.front ();
-  m_pending_events.pop ();
-  return event;
+  return m_pending_events.pop ();
 }
 
 void
@@ -2245,6 +2669,50 @@ process_t::send_exceptions (
     fatal_error ("send_exceptions failed (%s)", to_cstring (status));
 }
 
+void
+process_t::queue_exceptions (os_exception_mask_t exceptions, queue_t &queue)
+{
+  dbgapi_assert ((exceptions & os_queue_exception_mask) != 0
+                 && "should have queue exceptions");
+  dbgapi_assert (queue.is_suspended ());
+
+  auto it = std::find_if (m_queued_exceptions.begin (),
+                          m_queued_exceptions.end (), [&] (const auto &entry)
+                          { return entry.first == queue.id (); });
+
+  if (it != m_queued_exceptions.end ())
+    it->second |= exceptions;
+  else
+    m_queued_exceptions.emplace_back (queue.id (), exceptions);
+}
+
+void
+process_t::send_queued_exceptions (const std::vector<queue_t *> &queues)
+{
+  if (m_queued_exceptions.empty ())
+    return;
+
+  /* Send the exceptions in the order they were first recorded, keeping those
+     of the queues that are not being resumed.  */
+  auto it = std::remove_if (
+    m_queued_exceptions.begin (), m_queued_exceptions.end (),
+    [&] (const auto &entry)
+    {
+      auto queue_it = std::find_if (queues.begin (), queues.end (),
+                                    [&] (const queue_t *queue)
+                                    { return queue->id () == entry.first; });
+
+      if (queue_it == queues.end ())
+        return find (entry.first) == nullptr;
+
+      if ((*queue_it)->is_valid ())
+        send_exceptions (entry.second, *queue_it);
+      return true;
+    });
+
+  m_queued_exceptions.erase (it, m_queued_exceptions.end ());
+}
+
 amd_dbgapi_status_t
 process_t::client_process_get_info (amd_dbgapi_client_process_info_t query,
                                     size_t value_size, void *value) const
@@ -2370,6 +2838,33 @@ amd_dbgapi_process_set_wave_creation (amd_dbgapi_process_id_t process_id,
   TRACE_END ();
 }
 
+amd_dbgapi_status_t AMD_DBGAPI
+amd_dbgapi_process_set_event_processing (
+  amd_dbgapi_process_id_t process_id, amd_dbgapi_event_processing_t processing)
+{
+  TRACE_BEGIN (param_in (process_id), param_in (processing));
+  TRY
+  {
+    if (!detail::is_initialized)
+      THROW (AMD_DBGAPI_STATUS_ERROR_NOT_INITIALIZED);
+
+    process_t *process = process_t::find (process_id);
+
+    if (process == nullptr)
+      THROW (AMD_DBGAPI_STATUS_ERROR_INVALID_PROCESS_ID);
+
+    if (processing != AMD_DBGAPI_EVENT_PROCESSING_SYNCHRONOUS
+        && processing != AMD_DBGAPI_EVENT_PROCESSING_PIPELINED)
+      THROW (AMD_DBGAPI_STATUS_ERROR_INVALID_ARGUMENT);
+
+    process->set_event_processing (processing);
+  }
+  CATCH (AMD_DBGAPI_STATUS_ERROR_NOT_INITIALIZED,
+         AMD_DBGAPI_STATUS_ERROR_INVALID_PROCESS_ID,
+         AMD_DBGAPI_STATUS_ERROR_INVALID_ARGUMENT);
+  TRACE_END ();
+}
+
 amd_dbgapi_status_t AMD_DBGAPI
 amd_dbgapi_process_freeze (amd_dbgapi_process_id_t process_id)
 {
@@ -2427,6 +2922,44 @@ amd_dbgapi_process_unfreeze (amd_dbgapi_process_id_t process_id)
   TRACE_END ();
 }
 
+amd_dbgapi_status_t AMD_DBGAPI
+amd_dbgapi_process_write_gpu_snapshot (amd_dbgapi_process_id_t process_id,
+                                       int fd)
+{
+  TRACE_BEGIN (param_in (process_id), param_in (fd));
+  TRY
+  {
+    if (!detail::is_initialized)
+      THROW (AMD_DBGAPI_STATUS_ERROR_NOT_INITIALIZED);
+
+    process_t *process = process_t::find (process_id);
+
+    if (process == nullptr)
+      THROW (AMD_DBGAPI_STATUS_ERROR_INVALID_PROCESS_ID);
+
+    /* Reject a file descriptor that is not open before anything is written,
+       so that an invalid descriptor is not reported as a write error.  */
+    if (fd < 0 || ::fcntl (fd, F_GETFD) == -1)
+      THROW (AMD_DBGAPI_STATUS_ERROR_INVALID_ARGUMENT);
+
+    if (process->from_core ())
+      THROW (AMD_DBGAPI_STATUS_ERROR_NOT_AVAILABLE);
+
+    if (!process->is_frozen ())
+      THROW (AMD_DBGAPI_STATUS_ERROR_PROCESS_NOT_FROZEN);
+
+    process->write_gpu_snapshot (fd);
+  }
+  CATCH (AMD_DBGAPI_STATUS_ERROR_NOT_INITIALIZED,
+         AMD_DBGAPI_STATUS_ERROR_INVALID_PROCESS_ID,
+         AMD_DBGAPI_STATUS_ERROR_INVALID_ARGUMENT,
+         AMD_DBGAPI_STATUS_ERROR_PROCESS_NOT_FROZEN,
+         AMD_DBGAPI_STATUS_ERROR_NOT_AVAILABLE,
+         AMD_DBGAPI_STATUS_ERROR_RESTRICTION, AMD_DBGAPI_STATUS_ERROR,
+         AMD_DBGAPI_STATUS_ERROR_CLIENT_CALLBACK);
+  TRACE_END ();
+}
+
 amd_dbgapi_status_t AMD_DBGAPI
 amd_dbgapi_process_attach (amd_dbgapi_client_process_id_t client_process_id,
                            amd_dbgapi_process_id_t *process_id)
@@ -2589,3 +3122,158 @@ amd_dbgapi_set_alu_exceptions_precision (
          AMD_DBGAPI_STATUS_ERROR_NOT_SUPPORTED);
   TRACE_END ();
 }
+
+amd_dbgapi_status_t AMD_DBGAPI
+amd_dbgapi_process_set_breakpoint_condition (
+  amd_dbgapi_process_id_t process_id, amd_dbgapi_global_address_t address,
+  const void *saved_instruction_bytes, size_t term_count,
+  const amd_dbgapi_breakpoint_condition_term_t *terms)
+{
+  TRACE_BEGIN (param_in (process_id), make_hex (param_in (address)),
+               make_hex (make_ref (param_in (saved_instruction_bytes), 4)),
+               param_in (term_count), make_ref (param_in (terms), term_count));
+  TRY
+  {
+    if (!detail::is_initialized)
+      THROW (AMD_DBGAPI_STATUS_ERROR_NOT_INITIALIZED);
+
+    process_t *process = process_t::find (process_id);
+
+    if (process == nullptr)
+      THROW (AMD_DBGAPI_STATUS_ERROR_INVALID_PROCESS_ID);
+
+    if (saved_instruction_bytes == nullptr || terms == nullptr
+        || term_count == 0)
+      THROW (AMD_DBGAPI_STATUS_ERROR_INVALID_ARGUMENT);
+
+    for (size_t i = 0; i < term_count; ++i)
+      {
+        const auto &term = terms[i];
+
+        if (term.comparison < AMD_DBGAPI_BREAKPOINT_CONDITION_EQUAL
+            || term.comparison > AMD_DBGAPI_BREAKPOINT_CONDITION_GREATER_EQUAL)
+          THROW (AMD_DBGAPI_STATUS_ERROR_INVALID_ARGUMENT);
+
+        switch (term.kind)
+          {
+          case AMD_DBGAPI_BREAKPOINT_CONDITION_REGISTER:
+            if (!architecture_t::register_id_to_regnum (term.register_id)
+                || architecture_t::register_id_to_architecture (
+                     term.register_id)
+                     == nullptr)
+              THROW (AMD_DBGAPI_STATUS_ERROR_INVALID_REGISTER_ID);
+            break;
+
+          case AMD_DBGAPI_BREAKPOINT_CONDITION_WORKGROUP_COORD:
+            if (term.dimension > 2)
+              THROW (AMD_DBGAPI_STATUS_ERROR_INVALID_ARGUMENT);
+            break;
+
+          case AMD_DBGAPI_BREAKPOINT_CONDITION_ACTIVE_LANE_COUNT:
+          case AMD_DBGAPI_BREAKPOINT_CONDITION_HIT_COUNT:
+            break;
+
+          default:
+            THROW (AMD_DBGAPI_STATUS_ERROR_INVALID_ARGUMENT);
+          }
+      }
+
+    /* The breakpoint may be reached by waves of any architecture, so save as
+       many bytes as the largest breakpoint instruction.  */
+    size_t saved_instruction_size = 0;
+    for (auto &&architecture : architecture_t::all ())
+      saved_instruction_size
+        = std::max (saved_instruction_size,
+                    architecture.second->breakpoint_instruction ().size ());
+
+    const auto *bytes
+      = static_cast<const std::byte *> (saved_instruction_bytes);
+
+    process_t::breakpoint_condition_t condition;
+    condition.saved_instruction_bytes.assign (bytes,
+                                              bytes + saved_instruction_size);
+    condition.terms.assign (terms, terms + term_count);
+
+    process->set_breakpoint_condition (address, std::move (condition));
+  }
+  CATCH (AMD_DBGAPI_STATUS_ERROR_NOT_INITIALIZED,
+         AMD_DBGAPI_STATUS_ERROR_INVALID_PROCESS_ID,
+         AMD_DBGAPI_STATUS_ERROR_INVALID_REGISTER_ID,
+         AMD_DBGAPI_STATUS_ERROR_INVALID_ARGUMENT);
+  TRACE_END ();
+}
+
+amd_dbgapi_status_t AMD_DBGAPI
+amd_dbgapi_process_clear_breakpoint_condition (
+  amd_dbgapi_process_id_t process_id, amd_dbgapi_global_address_t address)
+{
+  TRACE_BEGIN (param_in (process_id), make_hex (param_in (address)));
+  TRY
+  {
+    if (!detail::is_initialized)
+      THROW (AMD_DBGAPI_STATUS_ERROR_NOT_INITIALIZED);
+
+    process_t *process = process_t::find (process_id);
+
+    if (process == nullptr)
+      THROW (AMD_DBGAPI_STATUS_ERROR_INVALID_PROCESS_ID);
+
+    if (!process->clear_breakpoint_condition (address))
+      THROW (AMD_DBGAPI_STATUS_ERROR_INVALID_ARGUMENT);
+  }
+  CATCH (AMD_DBGAPI_STATUS_ERROR_NOT_INITIALIZED,
+         AMD_DBGAPI_STATUS_ERROR_INVALID_PROCESS_ID,
+         AMD_DBGAPI_STATUS_ERROR_INVALID_ARGUMENT);
+  TRACE_END ();
+}
+
+amd_dbgapi_status_t AMD_DBGAPI
+amd_dbgapi_process_set_stop_reason_action (
+  amd_dbgapi_process_id_t process_id,
+  amd_dbgapi_wave_stop_reasons_t stop_reasons,
+  amd_dbgapi_stop_reason_action_t action)
+{
+  TRACE_BEGIN (param_in (process_id), param_in (stop_reasons),
+               param_in (action));
+  TRY
+  {
+    if (!detail::is_initialized)
+      THROW (AMD_DBGAPI_STATUS_ERROR_NOT_INITIALIZED);
+
+    process_t *process = process_t::find (process_id);
+
+    if (process == nullptr)
+      THROW (AMD_DBGAPI_STATUS_ERROR_INVALID_PROCESS_ID);
+
+    constexpr amd_dbgapi_wave_stop_reasons_t all_stop_reasons
+      = static_cast<amd_dbgapi_wave_stop_reasons_t> (
+        (static_cast<uint32_t> (AMD_DBGAPI_WAVE_STOP_REASON_FATAL_HALT) << 1)
+        - 1);
+
+    if (stop_reasons == AMD_DBGAPI_WAVE_STOP_REASON_NONE
+        || (stop_reasons & ~all_stop_reasons)
+             != AMD_DBGAPI_WAVE_STOP_REASON_NONE)
+      THROW (AMD_DBGAPI_STATUS_ERROR_INVALID_ARGUMENT);
+
+    if (action != AMD_DBGAPI_STOP_REASON_ACTION_REPORT
+        && action != AMD_DBGAPI_STOP_REASON_ACTION_RESUME
+        && action != AMD_DBGAPI_STOP_REASON_ACTION_TERMINATE)
+      THROW (AMD_DBGAPI_STATUS_ERROR_INVALID_ARGUMENT);
+
+    /* A wave resumed after a breakpoint would skip the instruction the
+       breakpoint replaced.  */
+    if (action == AMD_DBGAPI_STOP_REASON_ACTION_RESUME
+        && (stop_reasons
+            & ~(wave_t::resumable_stop_reason_mask
+                & ~AMD_DBGAPI_WAVE_STOP_REASON_BREAKPOINT))
+             != AMD_DBGAPI_WAVE_STOP_REASON_NONE)
+      THROW (AMD_DBGAPI_STATUS_ERROR_INVALID_ARGUMENT_COMPATIBILITY);
+
+    process->set_stop_reason_action (stop_reasons, action);
+  }
+  CATCH (AMD_DBGAPI_STATUS_ERROR_NOT_INITIALIZED,
+         AMD_DBGAPI_STATUS_ERROR_INVALID_PROCESS_ID,
+         AMD_DBGAPI_STATUS_ERROR_INVALID_ARGUMENT,
+         AMD_DBGAPI_STATUS_ERROR_INVALID_ARGUMENT_COMPATIBILITY);
+  TRACE_END ();
+}
@@ -44,7 +44,6 @@
 #include <functional>
 #include <memory>
 #include <optional>
-#include <queue>
 #include <string>
 #include <tuple>
 #include <type_traits>
@@ -90,7 +89,22 @@ public:
     spi_ttmps_setup_enabled = 1 << 1
   };
 
+  /* A condition evaluated when a wave stops at a client breakpoint.  */
+  struct breakpoint_condition_t
+  {
+    /* The original instruction bytes the breakpoint instruction replaced.  */
+    std::vector<std::byte> saved_instruction_bytes;
+    /* The terms of the condition, which holds if all the terms hold.  */
+    std::vector<amd_dbgapi_breakpoint_condition_term_t> terms;
+    /* Number of times a wave stopped at the breakpoint.  */
+    uint64_t hit_count{ 0 };
+  };
+
 private:
+  /* Number of queues suspended and resumed together when updating the waves
+     of a process the runtime was already enabled for during attach.  */
+  static constexpr size_t attach_queue_batch_size = 8;
+
   static handle_object_set_t<process_t> s_process_map;
 
   amd_dbgapi_client_process_id_t const m_client_process_id;
@@ -104,6 +118,10 @@ private:
 
   mutable memory_cache_t m_memory_cache;
   std::unique_ptr<os_driver_t> m_os_driver{};
+  /* The worker reading the context save areas of the suspended queues in the
+     pipelined event processing mode, see suspend_queues.  It is declared
+     after the os driver it uses, so that it is destroyed first.  */
+  std::unique_ptr<utils::worker_thread_t> m_prefetch_worker{};
   flag_t m_flags{};
 
   os_wave_launch_mode_t m_wave_launch_mode{ os_wave_launch_mode_t::normal };
@@ -119,9 +137,38 @@ private:
 
   bool m_forward_progress_needed{ true };
 
+  /* The exceptions raised by waves resumed while their queue is suspended,
+     merged per queue in the order the queues first raised them.  They are
+     sent to the runtime when the queue is resumed, see queue_exceptions.  */
+  std::vector<std::pair<amd_dbgapi_queue_id_t, os_exception_mask_t>>
+    m_queued_exceptions{};
+
+  amd_dbgapi_process_statistics_t m_statistics{};
+
+  /* The stop reasons for which waves are resumed or terminated by the library
+     instead of being reported, see amd_dbgapi_process_set_stop_reason_action.
+   */
+  amd_dbgapi_wave_stop_reasons_t m_resume_stop_reasons{};
+  amd_dbgapi_wave_stop_reasons_t m_terminate_stop_reasons{};
+
+  /* The conditions attached to client breakpoints, indexed by the address of
+     the breakpoint instruction.  */
+  std::unordered_map<amd_dbgapi_global_address_t, breakpoint_condition_t>
+    m_breakpoint_conditions{};
+
+  /* The kernel descriptors of the dispatches, indexed by kernel object
+     address.  All the dispatches of a kernel share its descriptor.  The cache
+     is cleared when a code object is unloaded, as its kernel objects may be
+     reused by the next code objects loaded.  */
+  std::unordered_map<
+    amd_dbgapi_global_address_t,
+    std::shared_ptr<const architecture_t::kernel_descriptor_t>>
+    m_kernel_descriptors{};
+
   pipe_t m_client_notifier_pipe{};
 
-  std::queue<event_t *> m_pending_events{};
+  /* The events queued and not yet returned by next_pending_event.  */
+  utils::ring_buffer_t<event_t *> m_pending_events{};
 
   std::tuple<
     handle_object_set_t<agent_t>, handle_object_set_t<breakpoint_t>,
@@ -181,6 +228,10 @@ public:
   inline void clear_flag (flag_t flags);
   inline bool is_flag_set (flag_t flags) const;
 
+  /* Transfer up to SIZE bytes of global memory starting at ADDRESS.  Return
+     the number of bytes transferred, which is 0 if the memory at ADDRESS is
+     not accessible.  Inaccessible memory is not reported with an exception
+     as it is expected when the client probes arbitrary addresses.  */
   [[nodiscard]] size_t
   read_global_memory_partial (amd_dbgapi_global_address_t address,
                               void *buffer, size_t size) const
@@ -237,6 +288,8 @@ public:
 
   void set_precise_alu_exceptions (bool enabled);
 
+  void set_event_processing (amd_dbgapi_event_processing_t processing);
+
   /* Suspend/resume a list of queues.  Queues may become invalid as a result of
      suspension/resumption, but not destroyed.  Queues made invalid will
      destroy associated dispatches and waves.  Since waves/dispatches can be
@@ -245,7 +298,43 @@ public:
   size_t suspend_queues (const std::vector<queue_t *> &queues,
                          const char *reason) const;
   size_t resume_queues (const std::vector<queue_t *> &queues,
-                        const char *reason) const;
+                        const char *reason);
+
+  /* Apply the pc writes staged in the suspended queues, so that their
+     context save areas hold the waves' pc before being written back.  */
+  void flush_pc_writes ();
+
+  amd_dbgapi_process_statistics_t &statistics () { return m_statistics; }
+
+  void set_stop_reason_action (amd_dbgapi_wave_stop_reasons_t stop_reasons,
+                               amd_dbgapi_stop_reason_action_t action);
+  /* Return the action to take for a wave stopped for STOP_REASONS.  */
+  amd_dbgapi_stop_reason_action_t
+  stop_reason_action (amd_dbgapi_wave_stop_reasons_t stop_reasons) const;
+
+  void set_breakpoint_condition (amd_dbgapi_global_address_t address,
+                                 breakpoint_condition_t condition)
+  {
+    m_breakpoint_conditions.insert_or_assign (address, std::move (condition));
+  }
+  bool clear_breakpoint_condition (amd_dbgapi_global_address_t address)
+  {
+    return m_breakpoint_conditions.erase (address) != 0;
+  }
+  /* Return the condition attached to the breakpoint at ADDRESS, or nullptr if
+     there is none.  */
+  breakpoint_condition_t *
+  find_breakpoint_condition (amd_dbgapi_global_address_t address)
+  {
+    auto it = m_breakpoint_conditions.find (address);
+    return it != m_breakpoint_conditions.end () ? &it->second : nullptr;
+  }
+
+  /* Return the kernel descriptor at KERNEL_OBJECT, reading it from memory
+     only the first time it is used by a dispatch.  */
+  std::shared_ptr<const architecture_t::kernel_descriptor_t>
+  kernel_descriptor (const architecture_t &architecture,
+                     amd_dbgapi_global_address_t kernel_object);
 
   /* update_* ensures that the only objects that exist are exactly those
      reported by the os_driver.  It creates new objects reported by os_driver,
@@ -263,12 +352,24 @@ public:
     os_exception_mask_t exceptions,
     std::variant<process_t *, agent_t *, queue_t *> source) const;
 
+  /* Record queue exceptions to send to the runtime before the suspended
+     queue is resumed.  Exceptions recorded for the same queue are merged and
+     sent with a single request.  */
+  void queue_exceptions (os_exception_mask_t exceptions, queue_t &queue);
+  /* Send the exceptions recorded for QUEUES, and discard those recorded for
+     queues that no longer exist.  */
+  void send_queued_exceptions (const std::vector<queue_t *> &queues);
+
   void attach ();
   void detach ();
 
   void freeze ();
   void unfreeze ();
 
+  /* Write a GPU snapshot of the frozen process to FD.  See
+     gpu_snapshot_header_t for the snapshot format.  */
+  void write_gpu_snapshot (file_desc_t fd);
+
   void enqueue_event (event_t &event);
   event_t *next_pending_event ();
 
@@ -364,6 +465,21 @@ public:
       .set_changed (has_changed);
   }
 
+  /* Record that the validity of the given object has changed.  */
+  template <typename Object> void validity_changed (const Object &object)
+  {
+    std::get<handle_object_set_t<Object>> (m_handle_object_sets)
+      .validity_changed (object);
+  }
+
+  /* Return the Objects added and removed since the given history epoch, or
+     an empty optional if the epoch is too old to compute the delta.  */
+  template <typename Object> auto delta (epoch_t epoch) const
+  {
+    return std::get<handle_object_set_t<Object>> (m_handle_object_sets)
+      .delta (epoch);
+  }
+
   /* Find an object with the given handle.  */
   template <typename Handle,
             std::enable_if_t<!std::is_void_v<object_type_from_handle_t<
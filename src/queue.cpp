@@ -35,9 +35,15 @@
 #include <hsa/amd_hsa_queue.h>
 #include <hsa/hsa.h>
 
+#include <algorithm>
 #include <array>
+#include <chrono>
 #include <cinttypes>
 #include <cstdint>
+#include <cstring>
+#include <deque>
+#include <future>
+#include <iterator>
 #include <limits>
 #include <memory>
 #include <string>
@@ -69,6 +75,11 @@ private:
   static constexpr uint64_t aql_packet_size = 64;
   static constexpr amd_dbgapi_size_t debugger_memory_chunk_size = 32;
 
+  /* While attaching, the registers of waves separated by at most this many
+     bytes in the context save area are read and written back with a single
+     memory access.  */
+  static constexpr amd_dbgapi_size_t attach_coalescing_max_gap = 4096;
+
   struct context_save_area_header_s
   {
     uint32_t control_stack_offset;
@@ -79,11 +90,29 @@ private:
     uint32_t debugger_memory_size;
   };
 
+  /* The header and the control stack of a context save area, read by the
+     process' prefetch worker.  If STATUS is not success, the control stack
+     could not be read and must be read again by update_waves.  */
+  struct staged_control_stack_t
+  {
+    amd_dbgapi_status_t status{ AMD_DBGAPI_STATUS_SUCCESS };
+    context_save_area_header_s header;
+    std::vector<uint32_t> control_stack;
+  };
+
+  /* The control stack of each XCC, read in the background since the queue
+     was suspended, see prefetch_context_save_area.  */
+  std::vector<std::future<staged_control_stack_t>> m_staged_control_stacks{};
+
+  static staged_control_stack_t
+  read_control_stack (const os_driver_t &os_driver,
+                      amd_dbgapi_global_address_t ctx_save_address);
+
   class aql_dispatch_t : public dispatch_t
   {
   private:
     hsa_kernel_dispatch_packet_t m_packet{};
-    std::unique_ptr<const architecture_t::kernel_descriptor_t>
+    std::shared_ptr<const architecture_t::kernel_descriptor_t>
       m_kernel_descriptor{};
 
   public:
@@ -108,6 +137,15 @@ private:
 
   std::optional<amd_dbgapi_os_queue_packet_id_t> m_read_packet_id{};
   std::optional<amd_dbgapi_os_queue_packet_id_t> m_write_packet_id{};
+
+  /* Cache of the packets [m_packet_cache_first_id, m_packet_cache_first_id +
+     m_packet_cache.size ()) already read from the ring buffer.  A packet is
+     only cached once its header is valid, since the producer publishes the
+     header last, and is discarded once the read packet id moves past it,
+     since the producer may then reuse its slot.  */
+  mutable amd_dbgapi_os_queue_packet_id_t m_packet_cache_first_id{ 0 };
+  mutable std::deque<std::array<std::byte, aql_packet_size>> m_packet_cache{};
+
   amd_dbgapi_global_address_t m_scratch_backing_memory_address{ 0 };
   amd_dbgapi_size_t m_per_xcc_scratch_backing_memory_size{ 0 };
   uint32_t m_compute_tmpring_size{ 0 };
@@ -133,13 +171,28 @@ private:
   std::optional<amd_dbgapi_os_queue_packet_id_t> get_os_queue_packet_id (
     const architecture_t::cwsr_record_t &cwsr_record) const;
 
+  /* Return the maximum number of clean bytes between the context save area
+     cache lines that are read or written back with a single memory access.  */
+  amd_dbgapi_size_t context_save_area_max_gap () const
+  {
+    return process ().is_flag_set (
+             process_t::flag_t::runtime_enable_during_attach)
+             ? attach_coalescing_max_gap
+             : 0;
+  }
+
   displaced_instruction_ptr_t
   allocate_displaced_instruction (const instruction_t &instruction) override;
 
   void queue_state_changed () override;
 
+  void write_back_context_save_area () override;
+
   void update_waves ();
 
+  void prefetch_context_save_area (utils::worker_thread_t &worker) override;
+  void discard_context_save_area_prefetch () override;
+
 public:
   aql_queue_t (amd_dbgapi_queue_id_t queue_id, const agent_t &agent,
                const os_queue_snapshot_entry_t &os_queue_info);
@@ -195,6 +248,15 @@ public:
   void active_packets_bytes (amd_dbgapi_os_queue_packet_id_t read_packet_id,
                              amd_dbgapi_os_queue_packet_id_t write_packet_id,
                              void *memory, size_t memory_size) const override;
+
+  std::vector<std::pair<amd_dbgapi_global_address_t /* address */,
+                        amd_dbgapi_size_t /* size */>>
+  memory_regions () const override;
+
+  std::vector<amd_dbgapi_queue_dispatch_packet_t>
+  decode_dispatch_packets (amd_dbgapi_os_queue_packet_id_t first_packet_id,
+                           const void *packets_bytes,
+                           size_t packets_byte_size) const override;
 };
 
 aql_queue_t::aql_dispatch_t::aql_dispatch_t (
@@ -206,11 +268,12 @@ aql_queue_t::aql_dispatch_t::aql_dispatch_t (
     = queue.address ()
       + (os_queue_packet_id * aql_packet_size) % queue.size ();
 
-  /* Read the dispatch packet and kernel descriptor.  */
+  /* Read the dispatch packet.  The kernel descriptor is shared with the
+     other dispatches of the same kernel.  */
   process ().read_global_memory (packet_address, &m_packet);
 
-  m_kernel_descriptor = architecture ().make_kernel_descriptor (
-    process (), m_packet.kernel_object);
+  m_kernel_descriptor
+    = process ().kernel_descriptor (architecture (), m_packet.kernel_object);
 }
 
 uint32_t
@@ -495,6 +558,23 @@ aql_queue_t::allocate_displaced_instruction (const instruction_t &instruction)
   return { displaced_instruction_address, deleter };
 }
 
+void
+aql_queue_t::write_back_context_save_area ()
+{
+  const auto xcc_count = agent ().os_info ().xcc_count;
+
+  /* Apply the pc writes staged while parking and unparking waves.  The dirty
+     lines they leave in the same save area page are then written back
+     together.  */
+  amd_dbgapi_size_t max_gap = context_save_area_max_gap ();
+  if (flush_pc_writes () != 0)
+    max_gap = std::max (max_gap, staged_pc_writes_max_gap);
+
+  process ().memory_cache ().write_back (
+    m_os_queue_info.ctx_save_restore_address,
+    xcc_count * m_os_queue_info.ctx_save_restore_area_size, max_gap);
+}
+
 void
 aql_queue_t::queue_state_changed ()
 {
@@ -515,9 +595,7 @@ aql_queue_t::queue_state_changed ()
          waves' cached registers does not require a queue suspend/resume.  The
          saved state cache lines will be discarded when this queue is next
          suspended again (see the 'case state_t::suspended:' below).  */
-      process ().memory_cache ().write_back (
-        m_os_queue_info.ctx_save_restore_address,
-        xcc_count * m_os_queue_info.ctx_save_restore_area_size);
+      write_back_context_save_area ();
       break;
 
     case state_t::suspended:
@@ -528,6 +606,10 @@ aql_queue_t::queue_state_changed ()
         m_os_queue_info.ctx_save_restore_address,
         xcc_count * m_os_queue_info.ctx_save_restore_area_size);
 
+      /* The pc writes staged before this suspension apply to the previous
+         context save, they must not overwrite the state just saved.  */
+      discard_pc_writes ();
+
       /* Refresh the scratch_backing_memory_location and
          scratch_backing_memory_size everytime the queue is suspended.
 
@@ -614,6 +696,73 @@ aql_queue_t::get_os_queue_packet_id (
   return os_queue_packet_id;
 }
 
+aql_queue_t::staged_control_stack_t
+aql_queue_t::read_control_stack (const os_driver_t &os_driver,
+                                 amd_dbgapi_global_address_t ctx_save_address)
+{
+  /* This runs on the prefetch worker thread, so only the os driver's worker
+     read may be used, and nothing may be logged.  Any failure is returned
+     for update_waves to report, and to read the memory again.  */
+  auto read_memory = [&] (amd_dbgapi_global_address_t address, void *buffer,
+                          size_t size)
+  {
+    size_t xfer_size = size;
+    amd_dbgapi_status_t status
+      = os_driver.read_global_memory_from_worker (address, buffer, &xfer_size);
+    if (status == AMD_DBGAPI_STATUS_SUCCESS && xfer_size != size)
+      status = AMD_DBGAPI_STATUS_ERROR_MEMORY_ACCESS;
+    return status;
+  };
+
+  staged_control_stack_t staged;
+  staged.status
+    = read_memory (ctx_save_address, &staged.header, sizeof (staged.header));
+  if (staged.status != AMD_DBGAPI_STATUS_SUCCESS)
+    return staged;
+
+  const size_t size = staged.header.control_stack_size;
+  if (!utils::is_aligned (size, sizeof (uint32_t)))
+    {
+      staged.status = AMD_DBGAPI_STATUS_ERROR;
+      return staged;
+    }
+
+  staged.control_stack.resize (size / sizeof (uint32_t));
+  staged.status
+    = read_memory (ctx_save_address + staged.header.control_stack_offset,
+                   staged.control_stack.data (), size);
+  return staged;
+}
+
+void
+aql_queue_t::prefetch_context_save_area (utils::worker_thread_t &worker)
+{
+  dbgapi_assert (m_staged_control_stacks.empty ());
+
+  const os_driver_t &os_driver = process ().os_driver ();
+  for (uint32_t xcc_id = 0; xcc_id < agent ().os_info ().xcc_count; ++xcc_id)
+    {
+      amd_dbgapi_global_address_t ctx_save_address
+        = m_os_queue_info.ctx_save_restore_address
+          + xcc_id * m_os_queue_info.ctx_save_restore_area_size;
+
+      m_staged_control_stacks.emplace_back (worker.submit (
+        [&os_driver, ctx_save_address] ()
+        { return read_control_stack (os_driver, ctx_save_address); }));
+    }
+}
+
+void
+aql_queue_t::discard_context_save_area_prefetch ()
+{
+  /* The jobs reference the os driver, wait for them to complete.  */
+  for (auto &&staged_control_stack : m_staged_control_stacks)
+    if (staged_control_stack.valid ())
+      staged_control_stack.wait ();
+
+  m_staged_control_stacks.clear ();
+}
+
 void
 aql_queue_t::update_waves ()
 {
@@ -629,16 +778,6 @@ aql_queue_t::update_waves ()
     dbgapi_assert (*this == cwsr_record->queue ());
     process_t &process = cwsr_record->process ();
 
-    auto prefetch_begin
-      = cwsr_record->register_address (amdgpu_regnum_t::first_hwreg).value ();
-    auto prefetch_end
-      = cwsr_record->register_address (amdgpu_regnum_t::last_ttmp).value ()
-        + architecture ().register_size (amdgpu_regnum_t::last_ttmp);
-
-    dbgapi_assert (prefetch_end > prefetch_begin);
-    process.memory_cache ().prefetch (prefetch_begin,
-                                      prefetch_end - prefetch_begin);
-
     wave_t *wave = nullptr;
 
     if (process.is_flag_set (process_t::flag_t::runtime_enable_during_attach))
@@ -746,6 +885,21 @@ aql_queue_t::update_waves ()
     if (wave->state () != AMD_DBGAPI_WAVE_STATE_STOP)
       ++*m_waves_running;
 
+    /* Step the waves that stopped at a breakpoint whose condition is false
+       over the breakpoint and resume them, without reporting them.  */
+    if (wave->needs_breakpoint_resume ())
+      wave->breakpoint_resume ();
+
+    /* Resume or terminate the waves stopped for reasons the client does not
+       want reported.  */
+    if (wave->state () == AMD_DBGAPI_WAVE_STATE_STOP
+        && wave->needs_stop_action ())
+      wave->apply_stop_action ();
+
+    /* Step again the waves with steps left, see wave_t::step_range.  */
+    if (wave->needs_step ())
+      wave->step ();
+
     /* Hide new waves halted at launch until the process' wave creation mode is
        changed to not stopped.  A wave is halted at launch if it is halted
        (status.halt=1) without having entered the trap handler, and its pc
@@ -787,9 +941,28 @@ aql_queue_t::update_waves ()
         = m_os_queue_info.ctx_save_restore_address
           + xcc_id * m_os_queue_info.ctx_save_restore_area_size;
 
+      /* Use the control stack read in the background when the queue was
+         suspended, if any.  */
+      std::optional<staged_control_stack_t> staged;
+      if (xcc_id < m_staged_control_stacks.size ())
+        {
+          staged = m_staged_control_stacks[xcc_id].get ();
+          if (staged->status != AMD_DBGAPI_STATUS_SUCCESS)
+            {
+              log_info ("could not prefetch %s's context save area #%u (%s), "
+                        "reading it again",
+                        to_cstring (id ()), xcc_id,
+                        to_cstring (staged->status));
+              staged.reset ();
+            }
+        }
+
       /* Retrieve the control stack and wave save area memory locations.  */
       context_save_area_header_s header;
-      process.read_global_memory (ctx_save_address, &header);
+      if (staged)
+        header = staged->header;
+      else
+        process.read_global_memory (ctx_save_address, &header);
 
       auto control_stack_begin
         = ctx_save_address + header.control_stack_offset;
@@ -816,18 +989,58 @@ aql_queue_t::update_waves ()
           if (!utils::is_aligned (size, sizeof (uint32_t)))
             fatal_error ("corrupted control stack");
 
-          auto memory
-            = std::make_unique<uint32_t[]> (size / sizeof (uint32_t));
-          process.read_global_memory (control_stack_begin, &memory[0], size);
+          std::vector<uint32_t> memory;
+          if (staged)
+            memory = std::move (staged->control_stack);
+          else
+            {
+              memory.resize (size / sizeof (uint32_t));
+              process.read_global_memory (control_stack_begin, memory.data (),
+                                          size);
+            }
 
           /* Decode the control stack.  For each entry in the control stack,
              the provided callback function is called with a CWSR record.  */
+          std::vector<std::unique_ptr<const architecture_t::cwsr_record_t>>
+            cwsr_records;
           wave_count += architecture ().control_stack_iterate (
-            *this, xcc_id, &memory[0], size / sizeof (uint32_t), wave_area_end,
-            wave_area_end - wave_area_begin, process_cwsr_record);
+            *this, xcc_id, memory.data (), memory.size (), wave_area_end,
+            wave_area_end - wave_area_begin,
+            [&cwsr_records] (auto cwsr_record)
+            { cwsr_records.emplace_back (std::move (cwsr_record)); });
+
+          /* Prefetch the hwregs and ttmps of all the waves before processing
+             them, so that the registers of neighbouring waves are read with
+             a single memory access.  */
+          std::vector<std::pair<amd_dbgapi_global_address_t, amd_dbgapi_size_t>>
+            prefetch_ranges;
+          prefetch_ranges.reserve (cwsr_records.size ());
+
+          for (auto &&cwsr_record : cwsr_records)
+            {
+              auto prefetch_begin
+                = cwsr_record->register_address (amdgpu_regnum_t::first_hwreg)
+                    .value ();
+              auto prefetch_end
+                = cwsr_record->register_address (amdgpu_regnum_t::last_ttmp)
+                    .value ()
+                  + architecture ().register_size (amdgpu_regnum_t::last_ttmp);
+
+              dbgapi_assert (prefetch_end > prefetch_begin);
+              prefetch_ranges.emplace_back (prefetch_begin,
+                                            prefetch_end - prefetch_begin);
+            }
+
+          process.memory_cache ().prefetch (std::move (prefetch_ranges),
+                                            context_save_area_max_gap ());
+
+          for (auto &&cwsr_record : cwsr_records)
+            process_cwsr_record (std::move (cwsr_record));
         }
     }
 
+  m_staged_control_stacks.clear ();
+
   if (wave_count)
     log_info ("%zu out of %zu wave%s running on %s", *m_waves_running,
               wave_count, wave_count > 1 ? "s" : "", to_cstring (id ()));
@@ -905,6 +1118,20 @@ aql_queue_t::active_packets_info (
   if (read_packet_id > write_packet_id)
     fatal_error ("corrupted read/write packet ids");
 
+  /* Discard the cached packets that were consumed.  If the read packet id is
+     below the cache, the queue was reset and the whole cache is stale.  */
+  if (read_packet_id < m_packet_cache_first_id)
+    m_packet_cache.clear ();
+
+  while (!m_packet_cache.empty () && m_packet_cache_first_id < read_packet_id)
+    {
+      m_packet_cache.pop_front ();
+      ++m_packet_cache_first_id;
+    }
+
+  if (m_packet_cache.empty ())
+    m_packet_cache_first_id = read_packet_id;
+
   *read_packet_id_p = read_packet_id;
   *write_packet_id_p = write_packet_id;
   *packets_byte_size_p = (write_packet_id - read_packet_id) * aql_packet_size;
@@ -931,28 +1158,135 @@ aql_queue_t::active_packets_bytes (
   if (!utils::is_power_of_two (size ()))
     fatal_error ("size is not a power of 2");
 
+  auto *bytes = static_cast<std::byte *> (memory);
+  amd_dbgapi_os_queue_packet_id_t packet_id = read_packet_id;
+  const amd_dbgapi_os_queue_packet_id_t cache_end_id
+    = m_packet_cache_first_id + m_packet_cache.size ();
+
+  /* Copy the packets already in the cache.  */
+  if (packet_id >= m_packet_cache_first_id)
+    for (; packet_id < std::min (write_packet_id, cache_end_id); ++packet_id)
+      std::memcpy (bytes + (packet_id - read_packet_id) * aql_packet_size,
+                   m_packet_cache[packet_id - m_packet_cache_first_id].data (),
+                   aql_packet_size);
+
+  if (packet_id == write_packet_id)
+    return;
+
+  /* Read the remaining packets from the ring buffer.  */
   const uint64_t id_mask = size () / aql_packet_size - 1;
+  std::byte *first_packet
+    = bytes + (packet_id - read_packet_id) * aql_packet_size;
 
   amd_dbgapi_global_address_t read_packet_ptr
-    = address () + (read_packet_id & id_mask) * aql_packet_size;
+    = address () + (packet_id & id_mask) * aql_packet_size;
   amd_dbgapi_global_address_t write_packet_ptr
     = address () + (write_packet_id & id_mask) * aql_packet_size;
 
   if (read_packet_ptr < write_packet_ptr)
-    process ().read_global_memory (read_packet_ptr, memory, packets_byte_size);
+    process ().read_global_memory (read_packet_ptr, first_packet,
+                                   write_packet_ptr - read_packet_ptr);
 
-  else if (read_packet_ptr > write_packet_ptr)
+  else /* The packets wrap around, or fill, the ring buffer.  */
     {
       size_t first_part_size = address () + size () - read_packet_ptr;
 
-      process ().read_global_memory (read_packet_ptr, memory, first_part_size);
+      process ().read_global_memory (read_packet_ptr, first_packet,
+                                     first_part_size);
 
       size_t second_part_size = write_packet_ptr - address ();
 
       process ().read_global_memory (
-        address (), static_cast<char *> (memory) + first_part_size,
-        second_part_size);
+        address (), first_packet + first_part_size, second_part_size);
+    }
+
+  /* Extend the cache with the packets just read if they are contiguous with
+     it.  Stop at the first packet with an invalid header, as the producer may
+     still be writing it.  */
+  if (packet_id != cache_end_id)
+    return;
+
+  for (; packet_id < write_packet_id; ++packet_id)
+    {
+      const std::byte *packet
+        = bytes + (packet_id - read_packet_id) * aql_packet_size;
+
+      uint16_t header;
+      std::memcpy (&header, packet, sizeof (header));
+
+      if (utils::bit_extract (header, HSA_PACKET_HEADER_TYPE,
+                              HSA_PACKET_HEADER_TYPE
+                                + HSA_PACKET_HEADER_WIDTH_TYPE - 1)
+          == HSA_PACKET_TYPE_INVALID)
+        break;
+
+      auto &entry = m_packet_cache.emplace_back ();
+      std::memcpy (entry.data (), packet, aql_packet_size);
+    }
+}
+
+std::vector<std::pair<amd_dbgapi_global_address_t, amd_dbgapi_size_t>>
+aql_queue_t::memory_regions () const
+{
+  return {
+    { address (), size () },
+    { m_os_queue_info.read_pointer_address
+        - offsetof (amd_queue_t, read_dispatch_id),
+      sizeof (amd_queue_t) },
+    { m_os_queue_info.write_pointer_address,
+      sizeof (amd_dbgapi_os_queue_packet_id_t) },
+    { m_os_queue_info.ctx_save_restore_address,
+      agent ().os_info ().xcc_count
+        * m_os_queue_info.ctx_save_restore_area_size },
+  };
+}
+
+std::vector<amd_dbgapi_queue_dispatch_packet_t>
+aql_queue_t::decode_dispatch_packets (
+  amd_dbgapi_os_queue_packet_id_t first_packet_id, const void *packets_bytes,
+  size_t packets_byte_size) const
+{
+  if (packets_byte_size % aql_packet_size)
+    throw api_error_t (AMD_DBGAPI_STATUS_ERROR_INVALID_ARGUMENT);
+
+  std::vector<amd_dbgapi_queue_dispatch_packet_t> dispatch_packets;
+  const auto *bytes = static_cast<const std::byte *> (packets_bytes);
+
+  for (size_t i = 0; i < packets_byte_size / aql_packet_size; ++i)
+    {
+      hsa_kernel_dispatch_packet_t packet;
+      std::memcpy (&packet, bytes + i * aql_packet_size, sizeof (packet));
+
+      if (utils::bit_extract (packet.header, HSA_PACKET_HEADER_TYPE,
+                              HSA_PACKET_HEADER_TYPE
+                                + HSA_PACKET_HEADER_WIDTH_TYPE - 1)
+          != HSA_PACKET_TYPE_KERNEL_DISPATCH)
+        continue;
+
+      amd_dbgapi_queue_dispatch_packet_t &dispatch_packet
+        = dispatch_packets.emplace_back ();
+
+      dispatch_packet.packet_id = first_packet_id + i;
+      dispatch_packet.grid_dimensions
+        = static_cast<uint32_t> (utils::bit_extract (
+          packet.setup, HSA_KERNEL_DISPATCH_PACKET_SETUP_DIMENSIONS,
+          HSA_KERNEL_DISPATCH_PACKET_SETUP_DIMENSIONS
+            + HSA_KERNEL_DISPATCH_PACKET_SETUP_WIDTH_DIMENSIONS - 1));
+      dispatch_packet.grid_sizes[0] = packet.grid_size_x;
+      dispatch_packet.grid_sizes[1] = packet.grid_size_y;
+      dispatch_packet.grid_sizes[2] = packet.grid_size_z;
+      dispatch_packet.workgroup_sizes[0] = packet.workgroup_size_x;
+      dispatch_packet.workgroup_sizes[1] = packet.workgroup_size_y;
+      dispatch_packet.workgroup_sizes[2] = packet.workgroup_size_z;
+      dispatch_packet.private_segment_size = packet.private_segment_size;
+      dispatch_packet.group_segment_size = packet.group_segment_size;
+      dispatch_packet.kernel_descriptor_address = packet.kernel_object;
+      dispatch_packet.kernel_argument_segment_address
+        = reinterpret_cast<amd_dbgapi_global_address_t> (
+          packet.kernarg_address);
     }
+
+  return dispatch_packets;
 }
 
 class unsupported_queue_t : public queue_t
@@ -975,6 +1309,15 @@ public:
   void active_packets_bytes (amd_dbgapi_os_queue_packet_id_t read_packet_id,
                              amd_dbgapi_os_queue_packet_id_t write_packet_id,
                              void *memory, size_t memory_size) const override;
+
+  std::vector<std::pair<amd_dbgapi_global_address_t /* address */,
+                        amd_dbgapi_size_t /* size */>>
+  memory_regions () const override;
+
+  std::vector<amd_dbgapi_queue_dispatch_packet_t>
+  decode_dispatch_packets (amd_dbgapi_os_queue_packet_id_t first_packet_id,
+                           const void *packets_bytes,
+                           size_t packets_byte_size) const override;
 };
 
 amd_dbgapi_os_queue_type_t
@@ -1017,6 +1360,21 @@ unsupported_queue_t::active_packets_bytes (
   throw api_error_t (AMD_DBGAPI_STATUS_ERROR_NOT_SUPPORTED);
 }
 
+std::vector<std::pair<amd_dbgapi_global_address_t, amd_dbgapi_size_t>>
+unsupported_queue_t::memory_regions () const
+{
+  /* The state of unsupported queues is not decoded.  */
+  return {};
+}
+
+std::vector<amd_dbgapi_queue_dispatch_packet_t>
+unsupported_queue_t::decode_dispatch_packets (
+  amd_dbgapi_os_queue_packet_id_t /* first_packet_id  */,
+  const void * /* packets_bytes  */, size_t /* packets_byte_size  */) const
+{
+  throw api_error_t (AMD_DBGAPI_STATUS_ERROR_NOT_SUPPORTED);
+}
+
 } /* namespace detail */
 
 bool
@@ -1040,6 +1398,83 @@ compute_queue_t::wave_state_changed (const wave_t &wave)
     ++*m_waves_running;
 }
 
+void
+compute_queue_t::stage_pc_write (amd_dbgapi_global_address_t pc_address,
+                                 amd_dbgapi_global_address_t pc)
+{
+  dbgapi_assert (is_suspended () && "the queue must be suspended");
+  m_staged_pc_writes.emplace_back (pc_address, pc);
+}
+
+size_t
+compute_queue_t::flush_pc_writes ()
+{
+  if (m_staged_pc_writes.empty ())
+    return 0;
+
+  /* Sort the writes by address.  The sort is stable so that the last write
+     staged for a wave's pc is the one applied, for example when a wave is
+     parked then unparked before the queue is resumed.  */
+  std::stable_sort (m_staged_pc_writes.begin (), m_staged_pc_writes.end (),
+                    [] (const auto &lhs, const auto &rhs)
+                    { return lhs.first < rhs.first; });
+
+  auto is_superseded = [this] (auto it)
+  {
+    auto next = std::next (it);
+    return next != m_staged_pc_writes.end () && next->first == it->first;
+  };
+
+  std::vector<std::pair<amd_dbgapi_global_address_t, amd_dbgapi_size_t>>
+    prefetch_ranges;
+  prefetch_ranges.reserve (m_staged_pc_writes.size ());
+
+  for (auto it = m_staged_pc_writes.begin (); it != m_staged_pc_writes.end ();
+       ++it)
+    if (!is_superseded (it))
+      prefetch_ranges.emplace_back (it->first,
+                                    sizeof (amd_dbgapi_global_address_t));
+
+  /* Fetch the cache lines holding the pc registers with as few memory
+     accesses as possible.  The queue is suspended, so the clean lines between
+     the pc registers of the same save area page can be fetched as well.  */
+  process ().memory_cache ().prefetch (prefetch_ranges,
+                                       staged_pc_writes_max_gap);
+
+  amd_dbgapi_global_address_t read_only_mask{ 0 };
+  if (auto *read_only
+      = architecture ().register_read_only_mask (amdgpu_regnum_t::pc);
+      read_only != nullptr)
+    read_only_mask
+      = *static_cast<const amd_dbgapi_global_address_t *> (read_only);
+
+  for (auto it = m_staged_pc_writes.begin (); it != m_staged_pc_writes.end ();
+       ++it)
+    {
+      if (is_superseded (it))
+        continue;
+
+      amd_dbgapi_global_address_t pc = it->second;
+
+      /* The read-only bits of the pc must be preserved.  */
+      if (read_only_mask != 0)
+        {
+          amd_dbgapi_global_address_t saved_pc;
+          process ().read_global_memory (it->first, &saved_pc);
+          pc = (pc & ~read_only_mask) | (saved_pc & read_only_mask);
+        }
+
+      process ().write_global_memory (it->first, &pc);
+    }
+
+  log_verbose ("wrote %zu staged pc register%s in %s",
+               prefetch_ranges.size (),
+               prefetch_ranges.size () > 1 ? "s" : "", to_cstring (id ()));
+
+  m_staged_pc_writes.clear ();
+  return prefetch_ranges.size ();
+}
+
 queue_t &
 queue_t::create (std::optional<amd_dbgapi_queue_id_t> queue_id,
                  const agent_t &agent,
@@ -1077,6 +1512,12 @@ queue_t::set_state (state_t state)
 
   m_state = state;
 
+  if (state == state_t::suspended)
+    {
+      m_last_suspend_time = std::chrono::steady_clock::now ();
+      m_last_suspend_epoch = next_suspend_epoch ();
+    }
+
   /* queue_t::set_state should not throw exceptions, if the process has exited,
      mark the queue as invalid.  */
   try
@@ -1090,7 +1531,12 @@ queue_t::set_state (state_t state)
     }
 
   if (m_state == state_t::invalid)
-    log_info ("invalidated %s", to_cstring (id ()));
+    {
+      /* The staged pc writes would be applied to a context save area that is
+         no longer in use.  */
+      discard_pc_writes ();
+      log_info ("invalidated %s", to_cstring (id ()));
+    }
 }
 
 amd_dbgapi_global_address_t
@@ -1297,3 +1743,111 @@ amd_dbgapi_queue_packet_list (
              make_hex (make_ref (make_ref (param_out (packets_bytes_p)),
                                  *packets_byte_size_p)));
 }
+
+amd_dbgapi_status_t AMD_DBGAPI
+amd_dbgapi_queue_packet_list_since (
+  amd_dbgapi_queue_id_t queue_id,
+  amd_dbgapi_os_queue_packet_id_t cursor_packet_id,
+  amd_dbgapi_os_queue_packet_id_t *read_packet_id_p,
+  amd_dbgapi_os_queue_packet_id_t *first_packet_id_p,
+  amd_dbgapi_os_queue_packet_id_t *write_packet_id_p,
+  amd_dbgapi_size_t *packets_byte_size_p, void **packets_bytes_p,
+  size_t *dispatch_packet_count_p,
+  amd_dbgapi_queue_dispatch_packet_t **dispatch_packets_p)
+{
+  TRACE_BEGIN (param_in (queue_id), make_hex (param_in (cursor_packet_id)),
+               param_in (read_packet_id_p), param_in (first_packet_id_p),
+               param_in (write_packet_id_p), param_in (packets_byte_size_p),
+               param_in (packets_bytes_p), param_in (dispatch_packet_count_p),
+               param_in (dispatch_packets_p));
+  TRY
+  {
+    if (!detail::is_initialized)
+      THROW (AMD_DBGAPI_STATUS_ERROR_NOT_INITIALIZED);
+
+    if (read_packet_id_p == nullptr || first_packet_id_p == nullptr
+        || write_packet_id_p == nullptr || packets_byte_size_p == nullptr
+        || (dispatch_packet_count_p != nullptr
+            && dispatch_packets_p == nullptr))
+      THROW (AMD_DBGAPI_STATUS_ERROR_INVALID_ARGUMENT);
+
+    queue_t *queue = find (queue_id);
+
+    if (queue == nullptr)
+      THROW (AMD_DBGAPI_STATUS_ERROR_INVALID_QUEUE_ID);
+
+    scoped_queue_suspend_t suspend (*queue, "refresh packet list");
+
+    amd_dbgapi_os_queue_packet_id_t read_packet_id, write_packet_id;
+    size_t active_packets_size;
+
+    queue->active_packets_info (&read_packet_id, &write_packet_id,
+                                &active_packets_size);
+
+    const amd_dbgapi_os_queue_packet_id_t first_packet_id
+      = std::min (std::max (cursor_packet_id, read_packet_id),
+                  write_packet_id);
+    const size_t memory_size
+      = (write_packet_id - first_packet_id) * queue->packet_size ();
+
+    std::unique_ptr<void, detail::DeallocateMemory> packets_memory;
+    std::vector<amd_dbgapi_queue_dispatch_packet_t> dispatch_packets;
+
+    if (packets_bytes_p != nullptr || dispatch_packet_count_p != nullptr)
+      {
+        packets_memory = allocate_memory (memory_size);
+
+        queue->active_packets_bytes (first_packet_id, write_packet_id,
+                                     packets_memory.get (), memory_size);
+
+        if (dispatch_packet_count_p != nullptr)
+          dispatch_packets = queue->decode_dispatch_packets (
+            first_packet_id, packets_memory.get (), memory_size);
+      }
+
+    std::unique_ptr<amd_dbgapi_queue_dispatch_packet_t[],
+                    detail::DeallocateMemory>
+      dispatch_packets_memory;
+
+    if (dispatch_packet_count_p != nullptr)
+      {
+        dispatch_packets_memory
+          = allocate_memory<amd_dbgapi_queue_dispatch_packet_t[]> (
+            dispatch_packets.size ()
+            * sizeof (amd_dbgapi_queue_dispatch_packet_t));
+
+        std::copy (dispatch_packets.begin (), dispatch_packets.end (),
+                   dispatch_packets_memory.get ());
+      }
+
+    if (packets_bytes_p != nullptr)
+      *packets_bytes_p = packets_memory.release ();
+
+    if (dispatch_packet_count_p != nullptr)
+      {
+        *dispatch_packet_count_p = dispatch_packets.size ();
+        *dispatch_packets_p = dispatch_packets_memory.release ();
+      }
+
+    *read_packet_id_p = read_packet_id;
+    *first_packet_id_p = first_packet_id;
+    *write_packet_id_p = write_packet_id;
+    *packets_byte_size_p = memory_size;
+  }
+  CATCH (AMD_DBGAPI_STATUS_ERROR_NOT_INITIALIZED,
+         AMD_DBGAPI_STATUS_ERROR_INVALID_QUEUE_ID,
+         AMD_DBGAPI_STATUS_ERROR_INVALID_ARGUMENT,
+         AMD_DBGAPI_STATUS_ERROR_NOT_SUPPORTED, AMD_DBGAPI_STATUS_ERROR,
+         AMD_DBGAPI_STATUS_ERROR_CLIENT_CALLBACK);
+  TRACE_END (make_hex (make_ref (param_out (read_packet_id_p))),
+             make_hex (make_ref (param_out (first_packet_id_p))),
+             make_hex (make_ref (param_out (write_packet_id_p))),
+             make_ref (param_out (packets_byte_size_p)),
+             make_hex (make_ref (make_ref (param_out (packets_bytes_p)),
+                                 *packets_byte_size_p)),
+             make_ref (param_out (dispatch_packet_count_p)),
+             make_ref (make_ref (param_out (dispatch_packets_p)),
+                       dispatch_packet_count_p != nullptr
+                         ? *dispatch_packet_count_p
+                         : 0));
+}
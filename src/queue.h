@@ -32,10 +32,13 @@
 #include "wave.h"
 #include "workgroup.h"
 
+#include <chrono>
 #include <cstddef>
 #include <functional>
 #include <memory>
 #include <optional>
+#include <utility>
+#include <vector>
 
 namespace amd::dbgapi
 {
@@ -66,6 +69,12 @@ private:
   state_t m_state{ state_t::running };
   epoch_t m_mark{ 0 };
 
+  /* Time and epoch of the last time the queue was suspended.  The waves of a
+     compute queue are updated from its saved state each time it is
+     suspended, so these tell how stale the queue's waves may be.  */
+  std::optional<std::chrono::steady_clock::time_point> m_last_suspend_time{};
+  epoch_t m_last_suspend_epoch{ 0 };
+
   const agent_t &m_agent;
 
   /* Called whenever the queue changes state.  */
@@ -105,6 +114,23 @@ public:
   epoch_t mark () const { return m_mark; }
   void set_mark (epoch_t mark) { m_mark = mark; }
 
+  static epoch_t next_suspend_epoch ()
+  {
+    static monotonic_counter_t<epoch_t, 1> next_queue_suspend_epoch{};
+    return next_queue_suspend_epoch ();
+  }
+
+  /* Return the time the queue was last suspended, or an empty optional if it
+     was never suspended.  */
+  std::optional<std::chrono::steady_clock::time_point>
+  last_suspend_time () const
+  {
+    return m_last_suspend_time;
+  }
+  /* Return the epoch of the last queue suspension, 0 if the queue was never
+     suspended.  Epochs increase with each suspension of any queue.  */
+  epoch_t last_suspend_epoch () const { return m_last_suspend_epoch; }
+
   /* Return the address of the memory holding the queue packets.  */
   amd_dbgapi_global_address_t address () const;
 
@@ -117,6 +143,32 @@ public:
   /* Return true if the queue does not have any visible activity.  */
   virtual bool is_all_stopped () const { return false; }
 
+  /* Start reading the context save area of this queue, which was just
+     suspended, on WORKER.  The next update of the queue's waves uses the
+     bytes read instead of accessing the memory.  */
+  virtual void
+  prefetch_context_save_area (utils::worker_thread_t & /* worker  */)
+  {
+  }
+
+  /* Wait for and drop the context save area read by
+     prefetch_context_save_area if it was not used.  */
+  virtual void discard_context_save_area_prefetch () {}
+
+  /* Write back the dirty cache lines of the context save area of this
+     suspended queue in a single pass, after applying its staged pc writes.
+   */
+  virtual void write_back_context_save_area () {}
+
+  /* Apply the pc writes staged while the queue is suspended, see
+     compute_queue_t::stage_pc_write.  Return the number of pc registers
+     written.  */
+  virtual size_t flush_pc_writes () { return 0; }
+
+  /* Drop the staged pc writes without applying them, for example because the
+     context save area they apply to is no longer valid.  */
+  virtual void discard_pc_writes () {}
+
   virtual void
   active_packets_info (amd_dbgapi_os_queue_packet_id_t *read_packet_id_p,
                        amd_dbgapi_os_queue_packet_id_t *write_packet_id_p,
@@ -127,6 +179,19 @@ public:
                         amd_dbgapi_os_queue_packet_id_t write_packet_id,
                         void *memory, size_t memory_size) const = 0;
 
+  /* Return the memory regions holding the state of this queue, for example
+     its packets and its context save area.  */
+  virtual std::vector<std::pair<amd_dbgapi_global_address_t /* address */,
+                                amd_dbgapi_size_t /* size */>>
+  memory_regions () const = 0;
+
+  /* Decode the kernel dispatch packets found in PACKETS_BYTES, the bytes of
+     the consecutive packets starting at FIRST_PACKET_ID.  */
+  virtual std::vector<amd_dbgapi_queue_dispatch_packet_t>
+  decode_dispatch_packets (amd_dbgapi_os_queue_packet_id_t first_packet_id,
+                           const void *packets_bytes,
+                           size_t packets_byte_size) const = 0;
+
   void get_info (amd_dbgapi_queue_info_t query, size_t value_size,
                  void *value) const;
 
@@ -186,6 +251,16 @@ protected:
      is suspended.  */
   std::optional<size_t> m_waves_running{};
 
+  /* Staged pc writes in the context save area separated by at most this many
+     bytes are fetched and written back with a single memory access.  */
+  static constexpr amd_dbgapi_size_t staged_pc_writes_max_gap = 4096;
+
+  /* The pc writes made by parking and unparking waves, staged until the queue
+     is resumed so that they are applied as a single batch.  */
+  std::vector<std::pair<amd_dbgapi_global_address_t /* pc address */,
+                        amd_dbgapi_global_address_t /* pc */>>
+    m_staged_pc_writes{};
+
   compute_queue_t (amd_dbgapi_queue_id_t queue_id, const agent_t &agent,
                    const os_queue_snapshot_entry_t &os_queue_info)
     : queue_t (queue_id, agent, os_queue_info), m_dummy_dispatch (*this)
@@ -197,6 +272,18 @@ public:
 
   bool is_all_stopped () const override;
 
+  /* Stage writing PC to the pc register saved at PC_ADDRESS in the context
+     save area.  The queue must be suspended.  */
+  void stage_pc_write (amd_dbgapi_global_address_t pc_address,
+                       amd_dbgapi_global_address_t pc);
+
+  /* Write the staged pc writes to the memory cache, sorted by address and
+     with only the last write to each address applied.  Return the number of
+     pc registers written.  */
+  size_t flush_pc_writes () override;
+
+  void discard_pc_writes () override { m_staged_pc_writes.clear (); }
+
   /* Return the address of a park instruction.  */
   virtual amd_dbgapi_global_address_t park_instruction_address () = 0;
   /* Return the address of a terminating instruction.  */
@@ -35,6 +35,7 @@
 #include <map>
 #include <optional>
 #include <utility>
+#include <vector>
 
 namespace amd::dbgapi
 {
@@ -121,9 +122,6 @@ register_class_t::get_info (amd_dbgapi_register_class_info_t query,
   throw api_error_t (AMD_DBGAPI_STATUS_ERROR_INVALID_ARGUMENT);
 }
 
-namespace
-{
-
 std::optional<uint64_t>
 amdgpu_regnum_to_dwarf_register (amdgpu_regnum_t regnum)
 {
@@ -192,70 +190,6 @@ amdgpu_regnum_to_dwarf_register (amdgpu_regnum_t regnum)
   return std::nullopt;
 }
 
-std::optional<amdgpu_regnum_t>
-dwarf_register_to_amdgpu_regnum (uint64_t dwarf_register)
-{
-  /* See https://llvm.org/docs/AMDGPUUsage.html#register-mapping.  */
-  if (dwarf_register == 1)
-    {
-      return amdgpu_regnum_t::pseudo_exec_32;
-    }
-  else if (dwarf_register == 17)
-    {
-      return amdgpu_regnum_t::pseudo_exec_64;
-    }
-  else if (dwarf_register == 16)
-    {
-      return amdgpu_regnum_t::pc;
-    }
-  else if (dwarf_register >= 32 && dwarf_register <= 95)
-    {
-      /* Scalar registers 0-63.  */
-      return amdgpu_regnum_t::first_sgpr + (dwarf_register - 32);
-    }
-  else if (dwarf_register == 128)
-    {
-      return amdgpu_regnum_t::pseudo_status;
-    }
-  else if (dwarf_register == 512)
-    {
-      return amdgpu_regnum_t::pseudo_vcc_32;
-    }
-  else if (dwarf_register == 768)
-    {
-      return amdgpu_regnum_t::pseudo_vcc_64;
-    }
-  else if (dwarf_register >= 1088 && dwarf_register <= 1129)
-    {
-      /* Scalar registers 64-105.  */
-      return amdgpu_regnum_t::first_sgpr + (dwarf_register - 1024);
-    }
-  else if (dwarf_register >= 1536 && dwarf_register <= 1791)
-    {
-      /* Vector registers 0-255 (wave32).  */
-      return amdgpu_regnum_t::first_vgpr_32 + (dwarf_register - 1536);
-    }
-  else if (dwarf_register >= 2048 && dwarf_register <= 2303)
-    {
-      /* Accumulation Vector registers 0-255 (wave32).  */
-      return amdgpu_regnum_t::first_accvgpr_32 + (dwarf_register - 2048);
-    }
-  else if (dwarf_register >= 2560 && dwarf_register <= 2815)
-    {
-      /* Vector registers 0-255 (wave64).  */
-      return amdgpu_regnum_t::first_vgpr_64 + (dwarf_register - 2560);
-    }
-  else if (dwarf_register >= 3072 && dwarf_register <= 3327)
-    {
-      /* Accumulation Vector registers 0-255 (wave64).  */
-      return amdgpu_regnum_t::first_accvgpr_64 + (dwarf_register - 3072);
-    }
-
-  return std::nullopt;
-}
-
-} /* anonymous namespace */
-
 } /* namespace amd::dbgapi */
 
 using namespace amd::dbgapi;
@@ -353,6 +287,9 @@ amd_dbgapi_register_get_info (amd_dbgapi_register_id_t register_id,
     if (value == nullptr)
       THROW (AMD_DBGAPI_STATUS_ERROR_INVALID_ARGUMENT);
 
+    const architecture_t::register_info_t &register_info
+      = architecture->register_info (*regnum);
+
     [&] ()
     {
       switch (query)
@@ -362,33 +299,26 @@ amd_dbgapi_register_get_info (amd_dbgapi_register_id_t register_id,
           return;
 
         case AMD_DBGAPI_REGISTER_INFO_NAME:
-          utils::get_info (value_size, value,
-                           architecture->register_name (*regnum));
+          utils::get_info (value_size, value, register_info.name);
           return;
 
         case AMD_DBGAPI_REGISTER_INFO_TYPE:
-          utils::get_info (value_size, value,
-                           architecture->register_type (*regnum));
+          utils::get_info (value_size, value, register_info.type);
           return;
 
         case AMD_DBGAPI_REGISTER_INFO_SIZE:
-          utils::get_info (value_size, value,
-                           architecture->register_size (*regnum));
+          utils::get_info (value_size, value, register_info.size);
           return;
 
         case AMD_DBGAPI_REGISTER_INFO_DWARF:
-          {
-            auto dwarf_register = amdgpu_regnum_to_dwarf_register (*regnum);
-            if (!dwarf_register)
-              THROW (AMD_DBGAPI_STATUS_ERROR_NOT_AVAILABLE);
+          if (!register_info.dwarf_register)
+            THROW (AMD_DBGAPI_STATUS_ERROR_NOT_AVAILABLE);
 
-            utils::get_info (value_size, value, *dwarf_register);
-            return;
-          }
+          utils::get_info (value_size, value, *register_info.dwarf_register);
+          return;
 
         case AMD_DBGAPI_REGISTER_INFO_PROPERTIES:
-          utils::get_info (value_size, value,
-                           architecture->register_properties (*regnum));
+          utils::get_info (value_size, value, register_info.properties);
           return;
         }
 
@@ -511,13 +441,10 @@ amd_dbgapi_dwarf_register_to_register (
     if (register_id == nullptr)
       THROW (AMD_DBGAPI_STATUS_ERROR_INVALID_ARGUMENT);
 
-    auto regnum = dwarf_register_to_amdgpu_regnum (dwarf_register);
+    auto regnum = architecture->dwarf_register_to_regnum (dwarf_register);
     if (!regnum)
       THROW (AMD_DBGAPI_STATUS_ERROR_INVALID_ARGUMENT_COMPATIBILITY);
 
-    if (!architecture->is_register_available (*regnum))
-      THROW (AMD_DBGAPI_STATUS_ERROR_INVALID_ARGUMENT_COMPATIBILITY);
-
     *register_id = architecture->regnum_to_register_id (*regnum);
   }
   CATCH (AMD_DBGAPI_STATUS_ERROR_NOT_INITIALIZED,
@@ -537,13 +464,15 @@ amd_dbgapi_read_register (amd_dbgapi_wave_id_t wave_id,
                param_in (value_size), param_in (value));
   TRY
   {
+    /* Return argument errors without raising an exception, clients often
+       probe registers that are not available in the wave.  */
     if (!detail::is_initialized)
-      THROW (AMD_DBGAPI_STATUS_ERROR_NOT_INITIALIZED);
+      return AMD_DBGAPI_STATUS_ERROR_NOT_INITIALIZED;
 
     wave_t *wave = find (wave_id);
 
     if (wave == nullptr)
-      THROW (AMD_DBGAPI_STATUS_ERROR_INVALID_WAVE_ID);
+      return AMD_DBGAPI_STATUS_ERROR_INVALID_WAVE_ID;
 
     auto regnum = architecture_t::register_id_to_regnum (register_id);
 
@@ -551,20 +480,20 @@ amd_dbgapi_read_register (amd_dbgapi_wave_id_t wave_id,
       = architecture_t::register_id_to_architecture (register_id);
 
     if (!regnum || architecture == nullptr)
-      THROW (AMD_DBGAPI_STATUS_ERROR_INVALID_REGISTER_ID);
+      return AMD_DBGAPI_STATUS_ERROR_INVALID_REGISTER_ID;
 
     if (wave->state () != AMD_DBGAPI_WAVE_STATE_STOP)
-      THROW (AMD_DBGAPI_STATUS_ERROR_WAVE_NOT_STOPPED);
+      return AMD_DBGAPI_STATUS_ERROR_WAVE_NOT_STOPPED;
 
     if (value == nullptr || !value_size)
-      THROW (AMD_DBGAPI_STATUS_ERROR_INVALID_ARGUMENT);
+      return AMD_DBGAPI_STATUS_ERROR_INVALID_ARGUMENT;
 
     if (*architecture != wave->architecture ()
         || (offset + value_size) > architecture->register_size (*regnum))
-      THROW (AMD_DBGAPI_STATUS_ERROR_INVALID_ARGUMENT_COMPATIBILITY);
+      return AMD_DBGAPI_STATUS_ERROR_INVALID_ARGUMENT_COMPATIBILITY;
 
     if (!wave->is_register_available (*regnum))
-      THROW (AMD_DBGAPI_STATUS_ERROR_REGISTER_NOT_AVAILABLE);
+      return AMD_DBGAPI_STATUS_ERROR_REGISTER_NOT_AVAILABLE;
 
     wave->read_register (*regnum, offset, value_size, value);
   }
@@ -639,6 +568,146 @@ amd_dbgapi_write_register (amd_dbgapi_wave_id_t wave_id,
   TRACE_END ();
 }
 
+namespace
+{
+
+/* Return the regnums of the vector REGISTERS of WAVE, checking that they are
+   valid arguments of amd_dbgapi_read_register_lane and
+   amd_dbgapi_write_register_lane.  */
+std::vector<amdgpu_regnum_t>
+lane_register_regnums (const wave_t &wave, size_t register_count,
+                       const amd_dbgapi_register_id_t *registers)
+{
+  std::vector<amdgpu_regnum_t> regnums;
+  regnums.reserve (register_count);
+
+  for (size_t i = 0; i < register_count; ++i)
+    {
+      auto regnum = architecture_t::register_id_to_regnum (registers[i]);
+
+      const architecture_t *architecture
+        = architecture_t::register_id_to_architecture (registers[i]);
+
+      if (!regnum || architecture == nullptr)
+        THROW (AMD_DBGAPI_STATUS_ERROR_INVALID_REGISTER_ID);
+
+      regnums.emplace_back (*regnum);
+    }
+
+  if (wave.state () != AMD_DBGAPI_WAVE_STATE_STOP)
+    THROW (AMD_DBGAPI_STATUS_ERROR_WAVE_NOT_STOPPED);
+
+  for (size_t i = 0; i < register_count; ++i)
+    if (*architecture_t::register_id_to_architecture (registers[i])
+          != wave.architecture ()
+        || regnums[i] < amdgpu_regnum_t::first_vgpr
+        || regnums[i] > amdgpu_regnum_t::last_vgpr
+        || wave.architecture ().register_size (regnums[i])
+             != wave.architecture ().register_size (regnums[0]))
+      THROW (AMD_DBGAPI_STATUS_ERROR_INVALID_ARGUMENT_COMPATIBILITY);
+
+  for (auto &&regnum : regnums)
+    if (!wave.is_register_available (regnum))
+      THROW (AMD_DBGAPI_STATUS_ERROR_REGISTER_NOT_AVAILABLE);
+
+  return regnums;
+}
+
+} /* anonymous namespace */
+
+amd_dbgapi_status_t AMD_DBGAPI
+amd_dbgapi_read_register_lane (amd_dbgapi_wave_id_t wave_id,
+                               amd_dbgapi_lane_id_t lane_id,
+                               size_t register_count,
+                               const amd_dbgapi_register_id_t *registers,
+                               void *values)
+{
+  TRACE_BEGIN (param_in (wave_id), param_in (lane_id),
+               param_in (register_count),
+               make_ref (param_in (registers), register_count),
+               param_in (values));
+  TRY
+  {
+    if (!detail::is_initialized)
+      THROW (AMD_DBGAPI_STATUS_ERROR_NOT_INITIALIZED);
+
+    wave_t *wave = find (wave_id);
+
+    if (wave == nullptr)
+      THROW (AMD_DBGAPI_STATUS_ERROR_INVALID_WAVE_ID);
+
+    if (lane_id == AMD_DBGAPI_LANE_NONE || lane_id >= wave->lane_count ())
+      THROW (AMD_DBGAPI_STATUS_ERROR_INVALID_LANE_ID);
+
+    if (registers == nullptr || values == nullptr || !register_count)
+      THROW (AMD_DBGAPI_STATUS_ERROR_INVALID_ARGUMENT);
+
+    auto regnums = lane_register_regnums (*wave, register_count, registers);
+
+    wave->read_register_lane (lane_id, regnums, values);
+  }
+  CATCH (AMD_DBGAPI_STATUS_ERROR_NOT_INITIALIZED,
+         AMD_DBGAPI_STATUS_ERROR_INVALID_WAVE_ID,
+         AMD_DBGAPI_STATUS_ERROR_INVALID_LANE_ID,
+         AMD_DBGAPI_STATUS_ERROR_INVALID_REGISTER_ID,
+         AMD_DBGAPI_STATUS_ERROR_WAVE_NOT_STOPPED,
+         AMD_DBGAPI_STATUS_ERROR_INVALID_ARGUMENT,
+         AMD_DBGAPI_STATUS_ERROR_INVALID_ARGUMENT_COMPATIBILITY,
+         AMD_DBGAPI_STATUS_ERROR_REGISTER_NOT_AVAILABLE);
+  TRACE_END ();
+}
+
+amd_dbgapi_status_t AMD_DBGAPI
+amd_dbgapi_write_register_lane (amd_dbgapi_wave_id_t wave_id,
+                                amd_dbgapi_lane_id_t lane_id,
+                                size_t register_count,
+                                const amd_dbgapi_register_id_t *registers,
+                                const void *values)
+{
+  TRACE_BEGIN (param_in (wave_id), param_in (lane_id),
+               param_in (register_count),
+               make_ref (param_in (registers), register_count),
+               param_in (values));
+  TRY
+  {
+    if (!detail::is_initialized)
+      THROW (AMD_DBGAPI_STATUS_ERROR_NOT_INITIALIZED);
+
+    wave_t *wave = find (wave_id);
+
+    if (wave == nullptr)
+      THROW (AMD_DBGAPI_STATUS_ERROR_INVALID_WAVE_ID);
+
+    if (wave->process ().is_frozen ())
+      THROW (AMD_DBGAPI_STATUS_ERROR_PROCESS_FROZEN);
+
+    if (lane_id == AMD_DBGAPI_LANE_NONE || lane_id >= wave->lane_count ())
+      THROW (AMD_DBGAPI_STATUS_ERROR_INVALID_LANE_ID);
+
+    if (registers == nullptr || values == nullptr || !register_count)
+      THROW (AMD_DBGAPI_STATUS_ERROR_INVALID_ARGUMENT);
+
+    auto regnums = lane_register_regnums (*wave, register_count, registers);
+
+    /* Is displaced stepping active?  */
+    if (wave->displaced_stepping () != nullptr)
+      THROW (AMD_DBGAPI_STATUS_ERROR_DISPLACED_STEPPING_ACTIVE);
+
+    wave->write_register_lane (lane_id, regnums, values);
+  }
+  CATCH (AMD_DBGAPI_STATUS_ERROR_NOT_INITIALIZED,
+         AMD_DBGAPI_STATUS_ERROR_INVALID_WAVE_ID,
+         AMD_DBGAPI_STATUS_ERROR_INVALID_LANE_ID,
+         AMD_DBGAPI_STATUS_ERROR_INVALID_REGISTER_ID,
+         AMD_DBGAPI_STATUS_ERROR_WAVE_NOT_STOPPED,
+         AMD_DBGAPI_STATUS_ERROR_DISPLACED_STEPPING_ACTIVE,
+         AMD_DBGAPI_STATUS_ERROR_INVALID_ARGUMENT,
+         AMD_DBGAPI_STATUS_ERROR_INVALID_ARGUMENT_COMPATIBILITY,
+         AMD_DBGAPI_STATUS_ERROR_REGISTER_NOT_AVAILABLE,
+         AMD_DBGAPI_STATUS_ERROR_PROCESS_FROZEN);
+  TRACE_END ();
+}
+
 amd_dbgapi_status_t AMD_DBGAPI
 amd_dbgapi_wave_register_exists (amd_dbgapi_wave_id_t wave_id,
                                  amd_dbgapi_register_id_t register_id,
@@ -28,6 +28,7 @@
 #include <cstddef>
 #include <cstdint>
 #include <map>
+#include <optional>
 #include <set>
 #include <string>
 #include <type_traits>
@@ -244,6 +245,10 @@ constexpr size_t amdgpu_hwregs_count
 constexpr size_t amdgpu_ttmps_count
   = amdgpu_regnum_t::last_ttmp - amdgpu_regnum_t::first_ttmp + 1;
 
+/* Return the DWARF register number mapped to REGNUM, if any.  */
+std::optional<uint64_t>
+amdgpu_regnum_to_dwarf_register (amdgpu_regnum_t regnum);
+
 /* Register class.  */
 
 class register_class_t
@@ -30,6 +30,7 @@
 
 #include <errno.h>
 #include <fcntl.h>
+#include <signal.h>
 #include <unistd.h>
 
 namespace amd::dbgapi
@@ -52,12 +53,17 @@ static_assert (
     && sizeof (amd_dbgapi_address_space_access_t) == sizeof (uint32_t)
     && sizeof (amd_dbgapi_agent_state_t) == sizeof (uint32_t)
     && sizeof (amd_dbgapi_breakpoint_action_t) == sizeof (uint32_t)
+    && sizeof (amd_dbgapi_breakpoint_condition_comparison_t)
+         == sizeof (uint32_t)
+    && sizeof (amd_dbgapi_breakpoint_condition_kind_t) == sizeof (uint32_t)
     && sizeof (amd_dbgapi_changed_t) == sizeof (uint32_t)
     && sizeof (amd_dbgapi_dispatch_barrier_t) == sizeof (uint32_t)
     && sizeof (amd_dbgapi_dispatch_fence_scope_t) == sizeof (uint32_t)
     && sizeof (amd_dbgapi_event_kind_t) == sizeof (uint32_t)
     && sizeof (amd_dbgapi_exceptions_t) == sizeof (uint32_t)
     && sizeof (amd_dbgapi_instruction_properties_t) == sizeof (uint32_t)
+    && sizeof (amd_dbgapi_list_delta_t) == sizeof (uint32_t)
+    && sizeof (amd_dbgapi_local_memory_snapshot_kind_t) == sizeof (uint32_t)
     && sizeof (amd_dbgapi_memory_precision_t) == sizeof (uint32_t)
     && sizeof (amd_dbgapi_os_queue_type_t) == sizeof (uint32_t)
     && sizeof (amd_dbgapi_queue_state_t) == sizeof (uint32_t)
@@ -65,6 +71,7 @@ static_assert (
     && sizeof (amd_dbgapi_register_properties_t) == sizeof (uint32_t)
     && sizeof (amd_dbgapi_runtime_state_t) == sizeof (uint32_t)
     && sizeof (amd_dbgapi_watchpoint_share_kind_t) == sizeof (uint32_t)
+    && sizeof (amd_dbgapi_wave_filter_kinds_t) == sizeof (uint32_t)
     && sizeof (amd_dbgapi_wave_state_t) == sizeof (uint32_t)
     && sizeof (amd_dbgapi_wave_stop_reasons_t) == sizeof (uint32_t),
   "an enum type is not compatible with the dbgapi enum underlying type");
@@ -209,6 +216,127 @@ template std::pair<amd_dbgapi_wave_id_t * /* objects */, size_t /* count */>
 get_handle_list<wave_t> (const std::vector<process_t *> &processes,
                          amd_dbgapi_changed_t *changed);
 
+process_queues_t
+suspend_queues (const std::vector<process_t *> &processes, const char *reason,
+                const std::function<bool (const queue_t &)> &filter)
+{
+  process_queues_t queues_needing_resume;
+
+  for (auto &&process : processes)
+    {
+      process->update_queues ();
+
+      std::vector<queue_t *> queues;
+      for (auto &&queue : process->range<queue_t> ())
+        if (!queue.is_suspended () && (!filter || filter (queue)))
+          queues.emplace_back (&queue);
+
+      process->suspend_queues (queues, reason);
+
+      if (process->forward_progress_needed ())
+        queues_needing_resume.emplace_back (process, std::move (queues));
+    }
+
+  return queues_needing_resume;
+}
+
+void
+resume_queues (const process_queues_t &queues, const char *reason)
+{
+  for (auto &&[process, process_queues] : queues)
+    process->resume_queues (process_queues, reason);
+}
+
+template <typename Object>
+std::tuple<typename Object::handle_type * /* added */, size_t /* count */,
+           typename Object::handle_type * /* removed */, size_t /* count */>
+get_handle_list_delta (const std::vector<process_t *> &processes,
+                       amd_dbgapi_list_cursor_t *cursor,
+                       amd_dbgapi_list_delta_t *delta_kind)
+{
+  using Handle = typename Object::handle_type;
+
+  /* Take the new cursor before collecting the deltas so that any object
+     added or removed after this point is reported by the next call.  */
+  const amd_dbgapi_list_cursor_t new_cursor
+    = handle_object_set_t<Object>::history_epoch ();
+
+  if (*cursor >= new_cursor)
+    throw api_error_t (AMD_DBGAPI_STATUS_ERROR_INVALID_ARGUMENT);
+
+  std::vector<std::pair<std::vector<Handle>, std::vector<Handle>>> deltas;
+  bool full_list = *cursor == AMD_DBGAPI_LIST_CURSOR_NONE;
+
+  for (auto &&process : processes)
+    {
+      if (full_list)
+        break;
+
+      auto delta = process->delta<Object> (*cursor);
+      if (!delta)
+        full_list = true;
+      else
+        deltas.emplace_back (std::move (*delta));
+    }
+
+  if (full_list)
+    {
+      auto [objects, count] = get_handle_list<Object> (processes, nullptr);
+      auto deallocate_objects = utils::make_scope_fail (
+        [objects = objects] () { deallocate_memory (objects); });
+
+      auto removed = allocate_memory<Handle[]> (0);
+
+      *cursor = new_cursor;
+      *delta_kind = AMD_DBGAPI_LIST_DELTA_FULL;
+      return { objects, count, removed.release (), 0 };
+    }
+
+  size_t added_count{ 0 }, removed_count{ 0 };
+  for (auto &&[added, removed] : deltas)
+    {
+      added_count += added.size ();
+      removed_count += removed.size ();
+    }
+
+  auto added = allocate_memory<Handle[]> (added_count * sizeof (Handle));
+  auto removed = allocate_memory<Handle[]> (removed_count * sizeof (Handle));
+
+  size_t added_pos{ 0 }, removed_pos{ 0 };
+  for (auto &&delta : deltas)
+    {
+      for (auto &&id : delta.first)
+        added[added_pos++] = id;
+      for (auto &&id : delta.second)
+        removed[removed_pos++] = id;
+    }
+
+  *cursor = new_cursor;
+  *delta_kind = AMD_DBGAPI_LIST_DELTA_INCREMENTAL;
+  return { added.release (), added_count, removed.release (), removed_count };
+}
+
+template std::tuple<amd_dbgapi_dispatch_id_t * /* added */, size_t /* count */,
+                    amd_dbgapi_dispatch_id_t * /* removed */,
+                    size_t /* count */>
+get_handle_list_delta<dispatch_t> (const std::vector<process_t *> &processes,
+                                   amd_dbgapi_list_cursor_t *cursor,
+                                   amd_dbgapi_list_delta_t *delta_kind);
+
+template std::tuple<amd_dbgapi_workgroup_id_t * /* added */,
+                    size_t /* count */,
+                    amd_dbgapi_workgroup_id_t * /* removed */,
+                    size_t /* count */>
+get_handle_list_delta<workgroup_t> (const std::vector<process_t *> &processes,
+                                    amd_dbgapi_list_cursor_t *cursor,
+                                    amd_dbgapi_list_delta_t *delta_kind);
+
+template std::tuple<amd_dbgapi_wave_id_t * /* added */, size_t /* count */,
+                    amd_dbgapi_wave_id_t * /* removed */, size_t /* count */>
+get_handle_list_delta<wave_t> (const std::vector<process_t *> &processes,
+                               amd_dbgapi_list_cursor_t *cursor,
+                               amd_dbgapi_list_delta_t *delta_kind);
+
 std::string
 human_readable_size (size_t size)
 {
@@ -222,6 +350,45 @@ human_readable_size (size_t size)
   return string_printf ("%.1fG", (double)size / GiB);
 }
 
+worker_thread_t::worker_thread_t () : m_thread ([this] () { run (); }) {}
+
+worker_thread_t::~worker_thread_t ()
+{
+  {
+    std::lock_guard<std::mutex> lock (m_mutex);
+    m_stopping = true;
+  }
+  m_jobs_cv.notify_one ();
+  m_thread.join ();
+}
+
+void
+worker_thread_t::run ()
+{
+  /* The signals sent to the client process must be handled by the client's
+     threads, never by the library's worker.  */
+  sigset_t signal_mask;
+  sigfillset (&signal_mask);
+  pthread_sigmask (SIG_BLOCK, &signal_mask, nullptr);
+
+  std::unique_lock<std::mutex> lock (m_mutex);
+  while (true)
+    {
+      m_jobs_cv.wait (lock,
+                      [this] () { return m_stopping || !m_jobs.empty (); });
+
+      if (m_jobs.empty ())
+        return;
+
+      std::function<void ()> job = std::move (m_jobs.front ());
+      m_jobs.pop_front ();
+
+      lock.unlock ();
+      job ();
+      lock.lock ();
+    }
+}
+
 } /* namespace utils */
 
 std::string
@@ -26,14 +26,22 @@
 #include "exception.h"
 
 #include <array>
+#include <atomic>
+#include <condition_variable>
 #include <cstdarg>
 #include <cstdint>
 #include <cstring>
+#include <deque>
 #include <exception>
 #include <functional>
+#include <future>
 #include <iterator>
+#include <memory>
+#include <mutex>
 #include <optional>
 #include <string>
+#include <thread>
+#include <tuple>
 #include <type_traits>
 #include <utility>
 #include <vector>
@@ -77,6 +85,7 @@ namespace amd::dbgapi
 
 class instruction_t;
 class process_t;
+class queue_t;
 
 using epoch_t = uint64_t;
 using file_desc_t = int;
@@ -651,6 +660,123 @@ public:
   }
 };
 
+/* A first-in first-out queue stored in a circular buffer.  Pushing and
+   popping are O(1) and do not allocate memory, unless an element is pushed
+   to a full buffer, in which case its capacity is doubled.
+
+   The head and tail indices are atomic so that one producer thread and one
+   consumer thread can use the queue concurrently, provided enough capacity
+   was reserved for push to never have to grow the buffer.  */
+template <typename T> class ring_buffer_t : private not_copyable_t
+{
+  static_assert (std::is_trivially_copyable_v<T>,
+                 "T must be trivially copyable");
+
+private:
+  std::vector<T> m_buffer;
+  /* Free-running indices of the next element to pop and to push.  The
+     element index in the buffer is the index modulo the buffer size, which
+     is always a power of two.  */
+  std::atomic<size_t> m_head{ 0 };
+  std::atomic<size_t> m_tail{ 0 };
+
+  void grow (size_t capacity)
+  {
+    const size_t head = m_head.load (std::memory_order_relaxed);
+    const size_t tail = m_tail.load (std::memory_order_relaxed);
+
+    std::vector<T> buffer (next_power_of_two (capacity));
+    for (size_t i = head; i != tail; ++i)
+      buffer[i - head] = m_buffer[i & (m_buffer.size () - 1)];
+
+    m_buffer = std::move (buffer);
+    m_head.store (0, std::memory_order_relaxed);
+    m_tail.store (tail - head, std::memory_order_release);
+  }
+
+public:
+  explicit ring_buffer_t (size_t capacity = 64)
+    : m_buffer (next_power_of_two (capacity))
+  {
+  }
+
+  size_t capacity () const { return m_buffer.size (); }
+  size_t size () const
+  {
+    return m_tail.load (std::memory_order_acquire)
+           - m_head.load (std::memory_order_acquire);
+  }
+  bool empty () const { return size () == 0; }
+
+  void reserve (size_t capacity)
+  {
+    if (capacity > m_buffer.size ())
+      grow (capacity);
+  }
+
+  void push (T value)
+  {
+    const size_t tail = m_tail.load (std::memory_order_relaxed);
+    if (tail - m_head.load (std::memory_order_acquire) == m_buffer.size ())
+      grow (m_buffer.size () * 2);
+
+    const size_t new_tail = m_tail.load (std::memory_order_relaxed);
+    m_buffer[new_tail & (m_buffer.size () - 1)] = value;
+    m_tail.store (new_tail + 1, std::memory_order_release);
+  }
+
+  T pop ()
+  {
+    const size_t head = m_head.load (std::memory_order_relaxed);
+    dbgapi_assert (head != m_tail.load (std::memory_order_acquire)
+                   && "ring buffer is empty");
+
+    T value = m_buffer[head & (m_buffer.size () - 1)];
+    m_head.store (head + 1, std::memory_order_release);
+    return value;
+  }
+};
+
+/* A thread running the jobs submitted to it, in order.  The library is not
+   thread safe, so jobs must only use their captured values, and services
+   that are explicitly safe to call concurrently such as
+   os_driver_t::xfer_global_memory_partial.  The remaining jobs are run
+   before the thread is joined by the destructor.  */
+class worker_thread_t : private not_copyable_t
+{
+private:
+  std::mutex m_mutex{};
+  std::condition_variable m_jobs_cv{};
+  std::deque<std::function<void ()>> m_jobs{};
+  bool m_stopping{ false };
+  /* The thread is started last, once the other members are initialized.  */
+  std::thread m_thread;
+
+  void run ();
+
+public:
+  worker_thread_t ();
+  ~worker_thread_t ();
+
+  /* Run JOB on the worker thread.  Return a future holding its result.  */
+  template <typename Function> auto submit (Function &&job)
+  {
+    using result_type = std::invoke_result_t<Function>;
+
+    auto task = std::make_shared<std::packaged_task<result_type ()>> (
+      std::forward<Function> (job));
+    std::future<result_type> future = task->get_future ();
+
+    {
+      std::lock_guard<std::mutex> lock (m_mutex);
+      m_jobs.emplace_back ([task] () { (*task) (); });
+    }
+    m_jobs_cv.notify_one ();
+
+    return future;
+  }
+};
+
 namespace detail
 {
 
@@ -727,6 +853,34 @@ std::pair<typename Object::handle_type * /* objects */, size_t /* count */>
 get_handle_list (const std::vector<process_t *> &processes,
                  amd_dbgapi_changed_t *changed);
 
+/* The queues suspended by suspend_queues, grouped by process.  */
+using process_queues_t
+  = std::vector<std::pair<process_t *, std::vector<queue_t *>>>;
+
+/* Refresh the queue list of the processes, and suspend their queues that
+   are not already suspended and are accepted by FILTER, so that the waves,
+   dispatches and workgroups of these queues are up to date.  Return the
+   queues to pass to resume_queues once the list is built: those of the
+   processes that need forward progress.  */
+process_queues_t
+suspend_queues (const std::vector<process_t *> &processes, const char *reason,
+                const std::function<bool (const queue_t &)> &filter = {});
+
+/* Resume the queues returned by suspend_queues.  */
+void resume_queues (const process_queues_t &queues, const char *reason);
+
+/* Return the Objects added to, and removed from, the processes since the
+   given cursor, and update the cursor.  If the cursor is
+   AMD_DBGAPI_LIST_CURSOR_NONE, or too old for the delta to be computed, the
+   added list contains all the Objects, the removed list is empty, and
+   *delta_kind is set to AMD_DBGAPI_LIST_DELTA_FULL.  */
+template <typename Object>
+std::tuple<typename Object::handle_type * /* added */, size_t /* count */,
+           typename Object::handle_type * /* removed */, size_t /* count */>
+get_handle_list_delta (const std::vector<process_t *> &processes,
+                       amd_dbgapi_list_cursor_t *cursor,
+                       amd_dbgapi_list_delta_t *delta_kind);
+
 template <char... Chars> struct string_literal
 {
   using type = string_literal;
@@ -36,10 +36,15 @@
 #include "workgroup.h"
 
 #include <algorithm>
+#include <chrono>
 #include <cinttypes>
 #include <cstring>
+#include <iterator>
+#include <limits>
+#include <map>
 #include <optional>
 #include <string>
+#include <tuple>
 #include <utility>
 
 namespace amd::dbgapi
@@ -63,12 +68,33 @@ wave_t::~wave_t ()
       displaced_stepping_t::release (m_displaced_stepping);
     }
 
+  if (m_counted_memory_violation)
+    counting_agent ().remove_memory_violation_wave ();
+
   /* If the wave was single-stepping, the client is expecting either a stop
      event, or a command terminated event.  */
   if (state () == AMD_DBGAPI_WAVE_STATE_SINGLE_STEP)
     raise_event (AMD_DBGAPI_EVENT_KIND_WAVE_COMMAND_TERMINATED);
 }
 
+void
+wave_t::update_memory_violation_count ()
+{
+  const bool memory_violation
+    = m_state == AMD_DBGAPI_WAVE_STATE_STOP
+      && (m_stop_reason & AMD_DBGAPI_WAVE_STOP_REASON_MEMORY_VIOLATION);
+
+  if (memory_violation == m_counted_memory_violation)
+    return;
+
+  if (memory_violation)
+    counting_agent ().add_memory_violation_wave ();
+  else
+    counting_agent ().remove_memory_violation_wave ();
+
+  m_counted_memory_violation = memory_violation;
+}
+
 const dispatch_t &
 wave_t::dispatch () const
 {
@@ -87,6 +113,14 @@ wave_t::agent () const
   return queue ().agent ();
 }
 
+agent_t &
+wave_t::counting_agent ()
+{
+  agent_t *agent = process ().find (this->agent ().id (), true);
+  dbgapi_assert (agent != nullptr && "the agent outlives its waves");
+  return *agent;
+}
+
 process_t &
 wave_t::process () const
 {
@@ -120,11 +154,13 @@ wave_t::set_visibility (visibility_t visibility)
   log_info ("changing %s's visibility to %s", to_cstring (id ()),
             visibility == visibility_t::visible ? "visible" : "hidden");
 
+  bool was_valid = is_valid ();
   m_visibility = visibility;
 
-  /* Since the visibility of this wave has changed, the list of waves returned
-     by the process has also changed.  */
-  process ().set_changed<wave_t> (true);
+  /* If the wave went from visible to hidden, or from hidden to visible, the
+     list of waves returned by the process has also changed.  */
+  if (is_valid () != was_valid)
+    process ().validity_changed (*this);
 }
 
 uint64_t
@@ -174,6 +210,9 @@ wave_t::instruction_at_pc (size_t pc_adjust) const
       return std::nullopt;
     }
 
+  if (instruction_size == 0)
+    return std::nullopt;
+
   /* Trim partial and unread bytes.  */
   instruction_bytes.resize (instruction_size);
 
@@ -194,7 +233,11 @@ wave_t::park ()
      wave will never be halted at such instructions.  */
   architecture ().save_pc_for_park (*this, pc ());
 
-  write_register (amdgpu_regnum_t::pc, queue ().park_instruction_address ());
+  /* The pc write is staged and applied with the other waves' pc writes when
+     the queue is resumed.  While the wave is parked, the pc saved in the
+     context save area is not accessed.  */
+  queue ().stage_pc_write (register_address (amdgpu_regnum_t::pc).value (),
+                           queue ().park_instruction_address ());
 
   m_is_parked = true;
   /* From now on, every read/write to the pc register will be done via
@@ -217,11 +260,12 @@ wave_t::unpark ()
 
   m_is_parked = false;
   /* From now on, every read/write to the pc register will be from/to the
-     context save area.  */
+     context save area.  The write is staged, see wave_t::park.  */
 
-  write_register (amdgpu_regnum_t::pc, saved_pc);
+  queue ().stage_pc_write (register_address (amdgpu_regnum_t::pc).value (),
+                           saved_pc);
 
-  log_verbose ("unparked %s (pc=%#" PRIx64 ")", to_cstring (id ()), pc ());
+  log_verbose ("unparked %s (pc=%#" PRIx64 ")", to_cstring (id ()), saved_pc);
 }
 
 void
@@ -388,7 +432,10 @@ wave_t::update (
      the last time the queue it belongs to was resumed.  */
   amd_dbgapi_wave_state_t prev_state = m_state;
   if (prev_state != AMD_DBGAPI_WAVE_STATE_STOP)
-    std::tie (m_state, m_stop_reason) = architecture.wave_get_state (*this);
+    {
+      std::tie (m_state, m_stop_reason) = architecture.wave_get_state (*this);
+      update_memory_violation_count ();
+    }
 
   auto wave_state_to_string = [] (amd_dbgapi_wave_state_t state,
                                   amd_dbgapi_wave_stop_reasons_t stop_reason)
@@ -417,12 +464,276 @@ wave_t::update (
       if (architecture.park_stopped_waves (process ().rocr_rdebug_version ()))
         park ();
 
+      /* The wave completed a step of step_range and has steps left, it is
+         stepped again by wave_t::step or queue_t::update_waves.  */
+      if (m_steps_remaining != 0)
+        {
+          if (m_stop_reason == AMD_DBGAPI_WAVE_STOP_REASON_SINGLE_STEP
+              && --m_steps_remaining != 0 && pc () >= m_step_range_start
+              && pc () < m_step_range_end)
+            return;
+
+          m_steps_remaining = 0;
+        }
+
+      if (m_breakpoint_step == breakpoint_step_t::stepping)
+        {
+          /* The wave completed the single-step over a breakpoint whose
+             condition is false, it is resumed by queue_t::update_waves.  */
+          if (m_stop_reason == AMD_DBGAPI_WAVE_STOP_REASON_SINGLE_STEP)
+            {
+              m_breakpoint_step = breakpoint_step_t::stepped;
+              return;
+            }
+
+          /* The wave stopped for another reason, report it as if it had not
+             been single-stepped.  */
+          displaced_stepping_complete ();
+          m_breakpoint_step = breakpoint_step_t::none;
+          m_stop_reason &= ~AMD_DBGAPI_WAVE_STOP_REASON_SINGLE_STEP;
+        }
+      else if (m_stop_reason == AMD_DBGAPI_WAVE_STOP_REASON_BREAKPOINT
+               && visibility () == visibility_t::visible
+               && is_breakpoint_condition_false ())
+        {
+          /* Do not report the wave, queue_t::update_waves resumes it.  */
+          m_breakpoint_step = breakpoint_step_t::at_breakpoint;
+          return;
+        }
+
+      /* Do not report the stop if the client asked for the wave to be
+         resumed or terminated, queue_t::update_waves takes the action.  */
+      if (visibility () == visibility_t::visible
+          && m_displaced_stepping == nullptr && !process ().from_core ())
+        {
+          m_stop_action = process ().stop_reason_action (m_stop_reason);
+          if (m_stop_action != AMD_DBGAPI_STOP_REASON_ACTION_REPORT)
+            return;
+        }
+
       if (visibility () == visibility_t::visible
           && m_stop_reason != AMD_DBGAPI_WAVE_STOP_REASON_NONE)
         raise_event (AMD_DBGAPI_EVENT_KIND_WAVE_STOP);
     }
 }
 
+void
+wave_t::step_range (amd_dbgapi_global_address_t range_start,
+                    amd_dbgapi_global_address_t range_end,
+                    amd_dbgapi_size_t step_count)
+{
+  dbgapi_assert (state () == AMD_DBGAPI_WAVE_STATE_STOP && "not stopped");
+  dbgapi_assert (step_count != 0 && range_start < range_end);
+
+  /* A wave with a displaced stepping buffer can only step the displaced
+     instruction.  */
+  m_steps_remaining = m_displaced_stepping != nullptr ? 1 : step_count;
+  m_step_range_start = range_start;
+  m_step_range_end = range_end;
+
+  step ();
+}
+
+void
+wave_t::step ()
+{
+  /* Simulated instructions complete immediately, and leave the wave stopped
+     with steps left.  Keep stepping until an instruction is executed by the
+     hardware, or the wave stops stepping.
+
+     A wave looping over instructions that are all simulated (for example an
+     s_branch to itself) would keep the host busy for as many steps as were
+     requested, so after max_simulated_steps the next instruction is executed
+     by the hardware.  The remaining steps are continued by
+     queue_t::update_waves when the wave reports the completed step.  */
+  auto restore_simulate_step
+    = utils::make_scope_exit ([this] () { m_simulate_step = true; });
+
+  for (size_t simulated_steps = 0;; ++simulated_steps)
+    {
+      m_simulate_step = simulated_steps < max_simulated_steps;
+      set_state (AMD_DBGAPI_WAVE_STATE_SINGLE_STEP);
+
+      if (!needs_step ())
+        break;
+    }
+}
+
+void
+wave_t::apply_stop_action ()
+{
+  dbgapi_assert (state () == AMD_DBGAPI_WAVE_STATE_STOP && "not stopped");
+  dbgapi_assert (needs_stop_action ());
+
+  log_verbose ("applying %s to %s (stop_reason=%s)",
+               to_cstring (m_stop_action), to_cstring (id ()),
+               to_cstring (m_stop_reason));
+
+  if (std::exchange (m_stop_action, AMD_DBGAPI_STOP_REASON_ACTION_REPORT)
+      == AMD_DBGAPI_STOP_REASON_ACTION_TERMINATE)
+    {
+      terminate ();
+      ++process ().statistics ().stop_reason_terminate_count;
+    }
+  else
+    {
+      set_state (AMD_DBGAPI_WAVE_STATE_RUN);
+      ++process ().statistics ().stop_reason_resume_count;
+    }
+}
+
+bool
+wave_t::is_breakpoint_condition_false ()
+{
+  if (process ().is_frozen () || process ().from_core ())
+    return false;
+
+  auto *condition = process ().find_breakpoint_condition (
+    pc () - architecture ().breakpoint_instruction_pc_adjust ());
+  if (condition == nullptr)
+    return false;
+
+  ++condition->hit_count;
+
+  auto compare = [] (amd_dbgapi_breakpoint_condition_comparison_t comparison,
+                     uint64_t lhs, uint64_t rhs)
+  {
+    switch (comparison)
+      {
+      case AMD_DBGAPI_BREAKPOINT_CONDITION_EQUAL:
+        return lhs == rhs;
+      case AMD_DBGAPI_BREAKPOINT_CONDITION_NOT_EQUAL:
+        return lhs != rhs;
+      case AMD_DBGAPI_BREAKPOINT_CONDITION_LESS:
+        return lhs < rhs;
+      case AMD_DBGAPI_BREAKPOINT_CONDITION_LESS_EQUAL:
+        return lhs <= rhs;
+      case AMD_DBGAPI_BREAKPOINT_CONDITION_GREATER:
+        return lhs > rhs;
+      case AMD_DBGAPI_BREAKPOINT_CONDITION_GREATER_EQUAL:
+        return lhs >= rhs;
+      }
+    dbgapi_assert_not_reached ("invalid comparison");
+  };
+
+  /* A term that cannot be evaluated is true.  */
+  for (auto &&term : condition->terms)
+    {
+      uint64_t value{ 0 };
+
+      switch (term.kind)
+        {
+        case AMD_DBGAPI_BREAKPOINT_CONDITION_REGISTER:
+          {
+            auto regnum
+              = architecture_t::register_id_to_regnum (term.register_id);
+            const architecture_t *register_architecture
+              = architecture_t::register_id_to_architecture (term.register_id);
+
+            if (!regnum || register_architecture != &architecture ()
+                || !is_register_available (*regnum))
+              continue;
+
+            read_register (
+              *regnum, 0,
+              std::min<size_t> (architecture ().register_size (*regnum),
+                                sizeof (value)),
+              &value);
+            break;
+          }
+
+        case AMD_DBGAPI_BREAKPOINT_CONDITION_ACTIVE_LANE_COUNT:
+          value = utils::bit_count (exec_mask ());
+          break;
+
+        case AMD_DBGAPI_BREAKPOINT_CONDITION_WORKGROUP_COORD:
+          if (!workgroup ().group_ids ())
+            continue;
+          value = (*workgroup ().group_ids ())[term.dimension];
+          break;
+
+        case AMD_DBGAPI_BREAKPOINT_CONDITION_HIT_COUNT:
+          value = condition->hit_count;
+          break;
+        }
+
+      if (!compare (term.comparison, value, term.value))
+        {
+          log_verbose ("%s stopped at a breakpoint whose condition is false",
+                       to_cstring (id ()));
+          return true;
+        }
+    }
+
+  return false;
+}
+
+void
+wave_t::breakpoint_resume ()
+{
+  dbgapi_assert (state () == AMD_DBGAPI_WAVE_STATE_STOP && "not stopped");
+  dbgapi_assert (needs_breakpoint_resume ());
+
+  if (m_breakpoint_step == breakpoint_step_t::at_breakpoint)
+    {
+      amd_dbgapi_global_address_t stop_pc = pc ();
+      amd_dbgapi_global_address_t breakpoint_pc
+        = stop_pc - architecture ().breakpoint_instruction_pc_adjust ();
+
+      const auto *condition = process ().find_breakpoint_condition (
+        breakpoint_pc);
+
+      /* Step over the breakpoint like a client would, see
+         amd_dbgapi_displaced_stepping_start.  */
+      write_register (amdgpu_regnum_t::pc, breakpoint_pc);
+
+      try
+        {
+          if (condition == nullptr)
+            throw api_error_t (AMD_DBGAPI_STATUS_ERROR_INVALID_ARGUMENT);
+
+          displaced_stepping_start (
+            condition->saved_instruction_bytes.data ());
+
+          /* Single-stepping a terminating instruction would report a command
+             terminated event to the client.  */
+          if (architecture ().is_terminating_instruction (
+                m_displaced_stepping->original_instruction ()))
+            {
+              displaced_stepping_complete ();
+              throw api_error_t (AMD_DBGAPI_STATUS_ERROR_ILLEGAL_INSTRUCTION);
+            }
+        }
+      catch (const api_error_t &e)
+        {
+          /* The wave cannot be stepped over the breakpoint, report it.  */
+          log_verbose ("cannot step %s over the breakpoint at %#" PRIx64
+                       " (%s)",
+                       to_cstring (id ()), breakpoint_pc,
+                       to_cstring (e.code ()));
+
+          write_register (amdgpu_regnum_t::pc, stop_pc);
+          m_breakpoint_step = breakpoint_step_t::none;
+          raise_event (AMD_DBGAPI_EVENT_KIND_WAVE_STOP);
+          return;
+        }
+
+      m_breakpoint_step = breakpoint_step_t::stepping;
+      set_state (AMD_DBGAPI_WAVE_STATE_SINGLE_STEP);
+
+      /* If the instruction was simulated, the wave has already stepped over
+         the breakpoint.  */
+      if (m_breakpoint_step != breakpoint_step_t::stepped)
+        return;
+    }
+
+  displaced_stepping_complete ();
+  m_breakpoint_step = breakpoint_step_t::none;
+  set_state (AMD_DBGAPI_WAVE_STATE_RUN);
+
+  ++process ().statistics ().breakpoint_condition_resume_count;
+}
+
 void
 wave_t::set_state (amd_dbgapi_wave_state_t state,
                    amd_dbgapi_exceptions_t exceptions)
@@ -465,6 +776,7 @@ wave_t::set_state (amd_dbgapi_wave_state_t state,
                && architecture.is_terminating_instruction (*instruction);
       }())
     {
+      m_steps_remaining = 0;
       terminate ();
       raise_event (AMD_DBGAPI_EVENT_KIND_WAVE_COMMAND_TERMINATED);
       return;
@@ -480,6 +792,7 @@ wave_t::set_state (amd_dbgapi_wave_state_t state,
 
   architecture.wave_set_state (*this, state);
   m_state = state;
+  update_memory_violation_count ();
   queue ().wave_state_changed (*this);
 
   if (architecture.park_stopped_waves (process ().rocr_rdebug_version ()))
@@ -522,6 +835,16 @@ wave_t::set_state (amd_dbgapi_wave_state_t state,
          report an event to acknowledge that the wave has stopped.  */
 
       m_stop_reason = AMD_DBGAPI_WAVE_STOP_REASON_NONE;
+      m_steps_remaining = 0;
+
+      /* The client did not single-step a wave stepping over a breakpoint
+         whose condition is false, report it as a running wave.  */
+      if (m_breakpoint_step == breakpoint_step_t::stepping)
+        {
+          displaced_stepping_complete ();
+          m_breakpoint_step = breakpoint_step_t::none;
+          prev_state = AMD_DBGAPI_WAVE_STATE_RUN;
+        }
 
       if (visibility () == visibility_t::visible)
         raise_event (prev_state == AMD_DBGAPI_WAVE_STATE_SINGLE_STEP
@@ -546,8 +869,10 @@ wave_t::set_state (amd_dbgapi_wave_state_t state,
                      m_displaced_stepping->original_instruction ());
           }
 
-        /* Simulate all instructions that can be simulated.  */
-        return instruction && architecture.can_simulate (*this, *instruction)
+        /* Simulate all instructions that can be simulated, unless the
+           hardware must execute this step, see wave_t::step.  */
+        return m_simulate_step && instruction
+               && architecture.can_simulate (*this, *instruction)
                && architecture.simulate (*this, pc (), *instruction);
       }())
     {
@@ -601,7 +926,9 @@ wave_t::set_state (amd_dbgapi_wave_state_t state,
       /* Halt the wave if resuming with exceptions.  */
       architecture.wave_set_halt (*this, true);
 
-      process ().send_exceptions (os_exceptions, &queue ());
+      /* The exceptions are sent to the runtime when the queue is resumed,
+         merged with those raised by the other waves of the queue.  */
+      process ().queue_exceptions (os_exceptions, queue ());
     }
 }
 
@@ -653,6 +980,10 @@ wave_t::read_register (amdgpu_regnum_t regnum, size_t offset,
       return;
     }
 
+  /* The pc saved in the context save area may have staged writes.  */
+  if (regnum == amdgpu_regnum_t::pc)
+    queue ().flush_pc_writes ();
+
   std::optional<scoped_queue_suspend_t> suspend;
   if (!queue ().is_suspended ()
       && !process ().memory_cache ().contains_all (*reg_addr + offset,
@@ -730,6 +1061,10 @@ wave_t::write_register (amdgpu_regnum_t regnum, size_t offset,
       return;
     }
 
+  /* Apply the staged writes first so that they do not overwrite this one.  */
+  if (regnum == amdgpu_regnum_t::pc)
+    queue ().flush_pc_writes ();
+
   std::optional<scoped_queue_suspend_t> suspend;
   if (!queue ().is_suspended ())
     {
@@ -789,6 +1124,153 @@ wave_t::write_register (amdgpu_regnum_t regnum, size_t offset,
   process ().write_global_memory (*reg_addr + offset, value, value_size);
 }
 
+void
+wave_t::read_register_lane (amd_dbgapi_lane_id_t lane_id,
+                            const std::vector<amdgpu_regnum_t> &regnums,
+                            void *value) const
+{
+  dbgapi_assert (lane_id < lane_count ());
+
+  if (regnums.empty ())
+    return;
+
+  /* A vector register holds one slice per lane, each lane's slice is at
+     offset LANE_ID * SLICE_SIZE in the register.  */
+  const size_t register_size = architecture ().register_size (regnums[0]);
+  const size_t slice_size = register_size / lane_count ();
+
+  auto register_rows = [&] ()
+  {
+    std::vector<std::pair<amd_dbgapi_global_address_t, size_t /* index */>>
+      rows;
+    rows.reserve (regnums.size ());
+
+    for (size_t i = 0; i < regnums.size (); ++i)
+      {
+        dbgapi_assert (regnums[i] >= amdgpu_regnum_t::first_vgpr
+                       && regnums[i] <= amdgpu_regnum_t::last_vgpr
+                       && architecture ().register_size (regnums[i])
+                            == register_size);
+
+        auto reg_addr = register_address (regnums[i]);
+        dbgapi_assert (reg_addr);
+        rows.emplace_back (*reg_addr, i);
+      }
+
+    /* Sort the rows by address so that consecutive registers are read with
+       a single memory access.  */
+    std::sort (rows.begin (), rows.end ());
+    return rows;
+  };
+
+  auto rows = register_rows ();
+
+  std::optional<scoped_queue_suspend_t> suspend;
+  if (!queue ().is_suspended ()
+      && !std::all_of (rows.begin (), rows.end (),
+                       [&] (const auto &row)
+                       {
+                         return process ().memory_cache ().contains_all (
+                           row.first + lane_id * slice_size, slice_size);
+                       }))
+    {
+      /* Get the wave_id before suspending the queue, as this wave could have
+         exited, and queue_t::update_waves may destroy this wave_t.  */
+      amd_dbgapi_wave_id_t wave_id = id ();
+
+      suspend.emplace (queue (), "read register lane");
+
+      /* Look for the wave_id again, the wave may have exited.  */
+      wave_t *wave = find (wave_id);
+      if (wave == nullptr)
+        throw api_error_t (AMD_DBGAPI_STATUS_ERROR_INVALID_WAVE_ID);
+
+      dbgapi_assert (wave == this);
+
+      /* The wave's saved state may have changed location in memory.  */
+      rows = register_rows ();
+    }
+
+  /* Read each run of contiguous rows, then gather the lane's slices.  */
+  std::vector<std::byte> buffer;
+  for (auto first = rows.begin (); first != rows.end ();)
+    {
+      auto last = std::next (first);
+      while (last != rows.end ()
+             && last->first == std::prev (last)->first + register_size)
+        ++last;
+
+      buffer.resize (std::distance (first, last) * register_size);
+      process ().read_global_memory (first->first, buffer.data (),
+                                     buffer.size ());
+
+      const std::byte *slice = buffer.data () + lane_id * slice_size;
+      for (auto row = first; row != last; ++row, slice += register_size)
+        memcpy (static_cast<std::byte *> (value) + row->second * slice_size,
+                slice, slice_size);
+
+      first = last;
+    }
+}
+
+void
+wave_t::write_register_lane (amd_dbgapi_lane_id_t lane_id,
+                             const std::vector<amdgpu_regnum_t> &regnums,
+                             const void *value) const
+{
+  dbgapi_assert (lane_id < lane_count ());
+
+  if (regnums.empty ())
+    return;
+
+  const size_t register_size = architecture ().register_size (regnums[0]);
+  const size_t slice_size = register_size / lane_count ();
+
+  std::optional<scoped_queue_suspend_t> suspend;
+  if (!queue ().is_suspended ())
+    {
+      /* Get the wave_id before suspending the queue, as this wave could have
+         exited, and queue_t::update_waves may destroy this wave_t.  */
+      amd_dbgapi_wave_id_t wave_id = id ();
+
+      suspend.emplace (queue (), "write register lane");
+
+      /* Look for the wave_id again, the wave may have exited.  */
+      wave_t *wave = find (wave_id);
+      if (wave == nullptr)
+        throw api_error_t (AMD_DBGAPI_STATUS_ERROR_INVALID_WAVE_ID);
+
+      dbgapi_assert (wave == this);
+    }
+
+  std::vector<std::pair<amd_dbgapi_global_address_t, amd_dbgapi_size_t>>
+    slices;
+  slices.reserve (regnums.size ());
+
+  for (auto &&regnum : regnums)
+    {
+      dbgapi_assert (regnum >= amdgpu_regnum_t::first_vgpr
+                     && regnum <= amdgpu_regnum_t::last_vgpr
+                     && architecture ().register_size (regnum)
+                          == register_size
+                     && !architecture ().register_read_only_mask (regnum));
+
+      auto reg_addr = register_address (regnum);
+      dbgapi_assert (reg_addr);
+      slices.emplace_back (*reg_addr + lane_id * slice_size, slice_size);
+    }
+
+  /* Fill in the cache lines holding the slices with as few memory accesses
+     as possible, so that the slices below are all written into the cache.
+     Only the lines holding the lane's slices are made dirty.  */
+  process ().memory_cache ().prefetch (slices, register_size);
+
+  for (size_t i = 0; i < slices.size (); ++i)
+    process ().write_global_memory (
+      slices[i].first, static_cast<const std::byte *> (value) + i * slice_size,
+      slice_size);
+}
+
 /* Return the wave's scratch memory region (address and size).  */
 std::pair<amd_dbgapi_global_address_t /* address */,
           amd_dbgapi_size_t /* size */>
@@ -831,6 +1313,20 @@ wave_t::xfer_private_memory (const address_space_t &address_space,
      so we can convert the private segment addresses and read/write from
      global memory.  */
 
+  /* Reading private_swizzled memory one interleave sized chunk at a time
+     is slow, read all the chunks at once instead.  */
+  if (read != nullptr
+      && address_space.kind () == address_space_t::kind_t::private_swizzled
+      && segment_address != address_space.null_address ())
+    {
+      if (lane_id == AMD_DBGAPI_LANE_NONE || lane_id >= lane_count ())
+        THROW (AMD_DBGAPI_STATUS_ERROR_INVALID_LANE_ID);
+
+      return read_private_swizzled_memory (
+        static_cast<const private_swizzled_address_space_t &> (address_space),
+        segment_address, { { lane_id, read } }, size);
+    }
+
   size_t xfer_bytes = 0;
   while (size > 0)
     {
@@ -847,12 +1343,7 @@ wave_t::xfer_private_memory (const address_space_t &address_space,
         {
           /* A conversion exception means that the segment address is out of
              bounds for the given address space.  Return the number of bytes
-             transferred so far, or throw a memory access error exception if
-             none were transferred.  */
-
-          if (!xfer_bytes)
-            throw memory_access_error_t (address_space, segment_address,
-                                         "address is out of bounds");
+             transferred so far, which is 0 if none were transferred.  */
           break;
         }
 
@@ -882,6 +1373,131 @@ wave_t::xfer_private_memory (const address_space_t &address_space,
   return xfer_bytes;
 }
 
+size_t
+wave_t::read_private_swizzled_memory (
+  const private_swizzled_address_space_t &address_space,
+  amd_dbgapi_segment_address_t segment_address,
+  const std::vector<std::pair<amd_dbgapi_lane_id_t, void *>> &lanes,
+  size_t size)
+{
+  /* Maximum number of bytes read from the scratch with a single access.  */
+  constexpr amd_dbgapi_size_t max_rows_size = 1024 * 1024;
+
+  /* A lane's byte at private address A is at offset
+     (A / INTERLEAVE) * ROW_SIZE + LANE_ID * INTERLEAVE + A % INTERLEAVE in
+     the scratch, so the private range of all the lanes is held in
+     consecutive rows of the scratch.  Read the rows with as few memory
+     accesses as possible, then de-interleave the lanes' chunks.  */
+  const amd_dbgapi_size_t interleave = address_space.interleave_size ();
+  const amd_dbgapi_size_t row_size = lane_count () * interleave;
+  const amd_dbgapi_size_t max_row_count
+    = std::max<amd_dbgapi_size_t> (max_rows_size / row_size, 1);
+  auto [scratch_base, scratch_size] = scratch_memory_region ();
+
+  std::vector<std::byte> rows;
+  size_t xfer_bytes = 0;
+  while (xfer_bytes < size)
+    {
+      const amd_dbgapi_segment_address_t address
+        = segment_address + xfer_bytes;
+      const amd_dbgapi_size_t first_row = address / interleave;
+      const amd_dbgapi_size_t row_count
+        = std::min ((address + size - xfer_bytes - 1) / interleave
+                      - first_row + 1,
+                    max_row_count);
+
+      const amd_dbgapi_size_t rows_offset = first_row * row_size;
+      if (rows_offset >= scratch_size)
+        break;
+
+      rows.resize (std::min (row_count * row_size, scratch_size - rows_offset));
+
+      const size_t rows_bytes = process ().read_global_memory_partial (
+        scratch_base + rows_offset, rows.data (), rows.size ());
+
+      /* The number of bytes each lane should get from these rows.  */
+      const size_t request_size
+        = std::min (size - xfer_bytes,
+                    row_count * interleave - address % interleave);
+
+      size_t min_lane_bytes = request_size;
+      for (auto &&[lane_id, buffer] : lanes)
+        {
+          size_t lane_bytes = 0;
+          for (amd_dbgapi_size_t chunk_offset = address % interleave,
+                                 row_offset = 0;
+               lane_bytes < request_size;
+               chunk_offset = 0, row_offset += row_size)
+            {
+              const size_t offset
+                = row_offset + lane_id * interleave + chunk_offset;
+              if (offset >= rows_bytes)
+                break;
+
+              const size_t chunk_size
+                = std::min ({ interleave - chunk_offset,
+                              request_size - lane_bytes,
+                              rows_bytes - offset });
+              memcpy (static_cast<std::byte *> (buffer) + xfer_bytes
+                        + lane_bytes,
+                      &rows[offset], chunk_size);
+              lane_bytes += chunk_size;
+            }
+
+          min_lane_bytes = std::min (min_lane_bytes, lane_bytes);
+        }
+
+      xfer_bytes += min_lane_bytes;
+
+      /* Stop at the first chunk that could not be read.  */
+      if (min_lane_bytes != request_size)
+        break;
+    }
+
+  return xfer_bytes;
+}
+
+size_t
+wave_t::read_segment_memory_lanes (const address_space_t &address_space,
+                                   amd_dbgapi_segment_address_t segment_address,
+                                   uint64_t lane_mask, void *read, size_t size)
+{
+  dbgapi_assert (state () == AMD_DBGAPI_WAVE_STATE_STOP
+                 && "the wave must be stopped to read memory");
+
+  std::vector<std::pair<amd_dbgapi_lane_id_t, void *>> lanes;
+  for (amd_dbgapi_lane_id_t lane_id = 0; lane_id < lane_count (); ++lane_id)
+    if ((lane_mask >> lane_id) & 1)
+      lanes.emplace_back (lane_id,
+                          static_cast<std::byte *> (read) + lane_id * size);
+
+  if (lanes.empty () || !size)
+    return 0;
+
+  auto [lowered_address_space, lowered_address]
+    = address_space.lower (segment_address);
+
+  if (lowered_address_space.kind ()
+        == address_space_t::kind_t::private_swizzled
+      && lowered_address != lowered_address_space.null_address ())
+    {
+      return read_private_swizzled_memory (
+        static_cast<const private_swizzled_address_space_t &> (
+          lowered_address_space),
+        lowered_address, lanes, size);
+    }
+
+  /* Other address spaces are read one lane at a time.  */
+  size_t xfer_bytes = size;
+  for (auto &&[lane_id, buffer] : lanes)
+    xfer_bytes
+      = std::min (xfer_bytes,
+                  xfer_segment_memory (address_space, segment_address, lane_id,
+                                       buffer, nullptr, xfer_bytes));
+
+  return xfer_bytes;
+}
+
 size_t
 wave_t::xfer_segment_memory (const address_space_t &address_space,
                              amd_dbgapi_segment_address_t segment_address,
@@ -933,8 +1549,12 @@ wave_t::client_visible_state () const
 {
   amd_dbgapi_wave_state_t state = this->state ();
 
+  /* A wave stepping over a breakpoint whose condition is false was not
+     single-stepped by the client.  */
   if (state != AMD_DBGAPI_WAVE_STATE_STOP)
-    return state;
+    return m_breakpoint_step != breakpoint_step_t::none
+             ? AMD_DBGAPI_WAVE_STATE_RUN
+             : state;
 
   if (const event_t *event = last_stop_event ();
       event == nullptr || event->state () >= event_t::state_t::reported)
@@ -1159,6 +1779,63 @@ amd_dbgapi_wave_resume (amd_dbgapi_wave_id_t wave_id,
   TRACE_END ();
 }
 
+amd_dbgapi_status_t AMD_DBGAPI
+amd_dbgapi_wave_step_range (amd_dbgapi_wave_id_t wave_id,
+                            amd_dbgapi_global_address_t range_start,
+                            amd_dbgapi_size_t range_size,
+                            amd_dbgapi_size_t step_count)
+{
+  TRACE_BEGIN (param_in (wave_id), make_hex (param_in (range_start)),
+               param_in (range_size), param_in (step_count));
+  TRY
+  {
+    if (!detail::is_initialized)
+      THROW (AMD_DBGAPI_STATUS_ERROR_NOT_INITIALIZED);
+
+    wave_t *wave = find (wave_id);
+
+    if (wave == nullptr)
+      THROW (AMD_DBGAPI_STATUS_ERROR_INVALID_WAVE_ID);
+
+    if (wave->process ().is_frozen ())
+      THROW (AMD_DBGAPI_STATUS_ERROR_PROCESS_FROZEN);
+
+    if (step_count == 0
+        || (range_size != 0 && range_start + range_size < range_start))
+      THROW (AMD_DBGAPI_STATUS_ERROR_INVALID_ARGUMENT);
+
+    if (wave->client_visible_state () != AMD_DBGAPI_WAVE_STATE_STOP)
+      THROW (AMD_DBGAPI_STATUS_ERROR_WAVE_NOT_STOPPED);
+
+    /* The wave is not resumable if the stop event is not yet processed.  */
+    if (const event_t *event = wave->last_stop_event ();
+        event != nullptr && event->state () < event_t::state_t::processed)
+      THROW (AMD_DBGAPI_STATUS_ERROR_WAVE_NOT_RESUMABLE);
+
+    scoped_queue_suspend_t suspend (wave->queue (), "step wave");
+
+    /* Look for the wave_id again, the wave may have exited.  */
+    if ((wave = find (wave_id)) == nullptr)
+      THROW (AMD_DBGAPI_STATUS_ERROR_INVALID_WAVE_ID);
+
+    /* Without a range, only the step count limits the steps.  */
+    if (range_size == 0)
+      {
+        range_start = 0;
+        range_size = std::numeric_limits<amd_dbgapi_size_t>::max ();
+      }
+
+    wave->step_range (range_start, range_start + range_size, step_count);
+  }
+  CATCH (AMD_DBGAPI_STATUS_ERROR_NOT_INITIALIZED,
+         AMD_DBGAPI_STATUS_ERROR_INVALID_WAVE_ID,
+         AMD_DBGAPI_STATUS_ERROR_INVALID_ARGUMENT,
+         AMD_DBGAPI_STATUS_ERROR_WAVE_NOT_STOPPED,
+         AMD_DBGAPI_STATUS_ERROR_WAVE_NOT_RESUMABLE,
+         AMD_DBGAPI_STATUS_ERROR_PROCESS_FROZEN);
+  TRACE_END ();
+}
+
 amd_dbgapi_status_t AMD_DBGAPI
 amd_dbgapi_wave_get_info (amd_dbgapi_wave_id_t wave_id,
                           amd_dbgapi_wave_info_t query, size_t value_size,
@@ -1168,13 +1845,15 @@ amd_dbgapi_wave_get_info (amd_dbgapi_wave_id_t wave_id,
                param_in (value));
   TRY
   {
+    /* Invalid wave ids and running waves are expected when a client polls
+       the waves, so return these errors without raising an exception.  */
     if (!detail::is_initialized)
-      THROW (AMD_DBGAPI_STATUS_ERROR_NOT_INITIALIZED);
+      return AMD_DBGAPI_STATUS_ERROR_NOT_INITIALIZED;
 
     wave_t *wave = find (wave_id);
 
     if (wave == nullptr)
-      THROW (AMD_DBGAPI_STATUS_ERROR_INVALID_WAVE_ID);
+      return AMD_DBGAPI_STATUS_ERROR_INVALID_WAVE_ID;
 
     switch (query)
       {
@@ -1183,7 +1862,7 @@ amd_dbgapi_wave_get_info (amd_dbgapi_wave_id_t wave_id,
       case AMD_DBGAPI_WAVE_INFO_EXEC_MASK:
       case AMD_DBGAPI_WAVE_INFO_WATCHPOINTS:
         if (wave->client_visible_state () != AMD_DBGAPI_WAVE_STATE_STOP)
-          THROW (AMD_DBGAPI_STATUS_ERROR_WAVE_NOT_STOPPED);
+          return AMD_DBGAPI_STATUS_ERROR_WAVE_NOT_STOPPED;
       default:
         break;
       };
@@ -1217,23 +1896,8 @@ amd_dbgapi_process_wave_list (amd_dbgapi_process_id_t process_id,
     if (waves == nullptr || wave_count == nullptr)
       THROW (AMD_DBGAPI_STATUS_ERROR_INVALID_ARGUMENT);
 
-    std::vector<std::pair<process_t *, std::vector<queue_t *>>>
-      queues_needing_resume;
-
-    for (auto &&process : processes)
-      {
-        process->update_queues ();
-
-        std::vector<queue_t *> queues;
-        for (auto &&queue : process->range<queue_t> ())
-          if (!queue.is_suspended ())
-            queues.emplace_back (&queue);
-
-        process->suspend_queues (queues, "refresh wave list");
-
-        if (process->forward_progress_needed ())
-          queues_needing_resume.emplace_back (process, std::move (queues));
-      }
+    auto queues_needing_resume
+      = utils::suspend_queues (processes, "refresh wave list");
 
     amd_dbgapi_changed_t wave_list_changed;
     auto wave_list = utils::get_handle_list<wave_t> (
@@ -1242,8 +1906,7 @@ amd_dbgapi_process_wave_list (amd_dbgapi_process_id_t process_id,
     auto deallocate_wave_list = utils::make_scope_fail (
       [&] () { amd::dbgapi::deallocate_memory (wave_list.first); });
 
-    for (auto &&[process, queues] : queues_needing_resume)
-      process->resume_queues (queues, "refresh wave list");
+    utils::resume_queues (queues_needing_resume, "refresh wave list");
 
     std::tie (*waves, *wave_count) = wave_list;
     if (changed != nullptr)
@@ -1257,3 +1920,536 @@ amd_dbgapi_process_wave_list (amd_dbgapi_process_id_t process_id,
              make_ref (make_ref (param_out (waves)), *wave_count),
              make_ref (param_out (changed)));
 }
+
+amd_dbgapi_status_t AMD_DBGAPI
+amd_dbgapi_process_wave_list_delta (
+  amd_dbgapi_process_id_t process_id, amd_dbgapi_list_cursor_t *cursor,
+  amd_dbgapi_list_delta_t *delta_kind, size_t *added_count,
+  amd_dbgapi_wave_id_t **added, size_t *removed_count,
+  amd_dbgapi_wave_id_t **removed)
+{
+  TRACE_BEGIN (param_in (process_id), param_in (cursor),
+               param_in (delta_kind), param_in (added_count),
+               param_in (added), param_in (removed_count),
+               param_in (removed));
+  TRY
+  {
+    if (!detail::is_initialized)
+      THROW (AMD_DBGAPI_STATUS_ERROR_NOT_INITIALIZED);
+
+    std::vector<process_t *> processes = process_t::match (process_id);
+
+    if (cursor == nullptr || delta_kind == nullptr || added == nullptr
+        || added_count == nullptr || removed == nullptr
+        || removed_count == nullptr)
+      THROW (AMD_DBGAPI_STATUS_ERROR_INVALID_ARGUMENT);
+
+    auto queues_needing_resume
+      = utils::suspend_queues (processes, "refresh wave list");
+
+    amd_dbgapi_list_cursor_t wave_list_cursor = *cursor;
+    amd_dbgapi_list_delta_t wave_list_delta_kind;
+    auto [added_list, added_list_count, removed_list, removed_list_count]
+      = utils::get_handle_list_delta<wave_t> (
+        processes, &wave_list_cursor, &wave_list_delta_kind);
+
+    auto deallocate_wave_lists = utils::make_scope_fail (
+      [added_list = added_list, removed_list = removed_list] ()
+      {
+        amd::dbgapi::deallocate_memory (added_list);
+        amd::dbgapi::deallocate_memory (removed_list);
+      });
+
+    utils::resume_queues (queues_needing_resume, "refresh wave list");
+
+    *cursor = wave_list_cursor;
+    *delta_kind = wave_list_delta_kind;
+    *added = added_list;
+    *added_count = added_list_count;
+    *removed = removed_list;
+    *removed_count = removed_list_count;
+  }
+  CATCH (AMD_DBGAPI_STATUS_ERROR_NOT_INITIALIZED,
+         AMD_DBGAPI_STATUS_ERROR_INVALID_PROCESS_ID,
+         AMD_DBGAPI_STATUS_ERROR_INVALID_ARGUMENT,
+         AMD_DBGAPI_STATUS_ERROR_CLIENT_CALLBACK);
+  TRACE_END (make_ref (param_out (cursor)), make_ref (param_out (delta_kind)),
+             make_ref (param_out (added_count)),
+             make_ref (make_ref (param_out (added)), *added_count),
+             make_ref (param_out (removed_count)),
+             make_ref (make_ref (param_out (removed)), *removed_count));
+}
+
+amd_dbgapi_status_t AMD_DBGAPI
+amd_dbgapi_process_wave_list_snapshot (amd_dbgapi_process_id_t process_id,
+                                       uint64_t max_snapshot_age,
+                                       size_t *wave_count,
+                                       amd_dbgapi_wave_id_t **waves,
+                                       uint64_t *snapshot_epoch,
+                                       uint64_t *snapshot_age)
+{
+  TRACE_BEGIN (param_in (process_id), param_in (max_snapshot_age),
+               param_in (wave_count), param_in (waves),
+               param_in (snapshot_epoch), param_in (snapshot_age));
+  TRY
+  {
+    if (!detail::is_initialized)
+      THROW (AMD_DBGAPI_STATUS_ERROR_NOT_INITIALIZED);
+
+    std::vector<process_t *> processes = process_t::match (process_id);
+
+    if (waves == nullptr || wave_count == nullptr || snapshot_epoch == nullptr
+        || snapshot_age == nullptr)
+      THROW (AMD_DBGAPI_STATUS_ERROR_INVALID_ARGUMENT);
+
+    const auto now = std::chrono::steady_clock::now ();
+
+    /* Return the age in microseconds of the waves of the given queue.  The
+       waves of a suspended queue are always up to date.  */
+    auto queue_snapshot_age = [&now] (const queue_t &queue) -> uint64_t
+    {
+      if (queue.is_suspended ())
+        return 0;
+
+      auto last_suspend_time = queue.last_suspend_time ();
+      if (!last_suspend_time)
+        return std::numeric_limits<uint64_t>::max ();
+
+      return std::chrono::duration_cast<std::chrono::microseconds> (
+               now - *last_suspend_time)
+        .count ();
+    };
+
+    /* Only refresh the queues whose saved state is older than requested.  If
+       no refresh is allowed, do not even look for new queues.  */
+    utils::process_queues_t queues_needing_resume;
+    if (max_snapshot_age != AMD_DBGAPI_WAVE_LIST_SNAPSHOT_NO_REFRESH)
+      queues_needing_resume = utils::suspend_queues (
+        processes, "refresh wave list snapshot",
+        [&] (const queue_t &queue)
+        {
+          return queue.is_valid ()
+                 && queue_snapshot_age (queue) > max_snapshot_age;
+        });
+
+    /* The snapshot is as old as its oldest queue.  */
+    epoch_t oldest_epoch{ 0 };
+    uint64_t oldest_age{ 0 };
+    bool first_queue{ true };
+    for (auto &&process : processes)
+      for (auto &&queue : process->range<queue_t> ())
+        {
+          if (!queue.is_valid ())
+            continue;
+
+          if (first_queue || queue.last_suspend_epoch () < oldest_epoch)
+            oldest_epoch = queue.last_suspend_epoch ();
+          oldest_age = std::max (oldest_age, queue_snapshot_age (queue));
+          first_queue = false;
+        }
+
+    auto wave_list = utils::get_handle_list<wave_t> (processes, nullptr);
+
+    auto deallocate_wave_list = utils::make_scope_fail (
+      [&] () { amd::dbgapi::deallocate_memory (wave_list.first); });
+
+    utils::resume_queues (queues_needing_resume, "refresh wave list snapshot");
+
+    std::tie (*waves, *wave_count) = wave_list;
+    *snapshot_epoch = oldest_epoch;
+    *snapshot_age = oldest_age;
+  }
+  CATCH (AMD_DBGAPI_STATUS_ERROR_NOT_INITIALIZED,
+         AMD_DBGAPI_STATUS_ERROR_INVALID_PROCESS_ID,
+         AMD_DBGAPI_STATUS_ERROR_INVALID_ARGUMENT,
+         AMD_DBGAPI_STATUS_ERROR_CLIENT_CALLBACK);
+  TRACE_END (make_ref (param_out (wave_count)),
+             make_ref (make_ref (param_out (waves)), *wave_count),
+             make_ref (param_out (snapshot_epoch)),
+             make_ref (param_out (snapshot_age)));
+}
+
+amd_dbgapi_status_t AMD_DBGAPI
+amd_dbgapi_process_wave_list_filtered (amd_dbgapi_process_id_t process_id,
+                                       const amd_dbgapi_wave_filter_t *filter,
+                                       size_t *wave_count,
+                                       amd_dbgapi_wave_id_t **waves)
+{
+  TRACE_BEGIN (param_in (process_id), make_ref (param_in (filter)),
+               param_in (wave_count), param_in (waves));
+  TRY
+  {
+    if (!detail::is_initialized)
+      THROW (AMD_DBGAPI_STATUS_ERROR_NOT_INITIALIZED);
+
+    std::vector<process_t *> processes = process_t::match (process_id);
+
+    if (filter == nullptr || waves == nullptr || wave_count == nullptr)
+      THROW (AMD_DBGAPI_STATUS_ERROR_INVALID_ARGUMENT);
+
+    constexpr int all_filter_kinds
+      = AMD_DBGAPI_WAVE_FILTER_STATE | AMD_DBGAPI_WAVE_FILTER_STOP_REASON
+        | AMD_DBGAPI_WAVE_FILTER_PC_RANGE | AMD_DBGAPI_WAVE_FILTER_QUEUE
+        | AMD_DBGAPI_WAVE_FILTER_DISPATCH | AMD_DBGAPI_WAVE_FILTER_AGENT;
+
+    const int kinds = filter->kinds;
+    if ((kinds & ~all_filter_kinds) != 0)
+      THROW (AMD_DBGAPI_STATUS_ERROR_INVALID_ARGUMENT);
+
+    if ((kinds & AMD_DBGAPI_WAVE_FILTER_STATE) != 0
+        && filter->state != AMD_DBGAPI_WAVE_STATE_RUN
+        && filter->state != AMD_DBGAPI_WAVE_STATE_SINGLE_STEP
+        && filter->state != AMD_DBGAPI_WAVE_STATE_STOP)
+      THROW (AMD_DBGAPI_STATUS_ERROR_INVALID_ARGUMENT);
+
+    if ((kinds & AMD_DBGAPI_WAVE_FILTER_PC_RANGE) != 0
+        && filter->pc_begin > filter->pc_end)
+      THROW (AMD_DBGAPI_STATUS_ERROR_INVALID_ARGUMENT);
+
+    auto matches = [filter, kinds] (const wave_t &wave)
+    {
+      const amd_dbgapi_wave_state_t state = wave.client_visible_state ();
+
+      if ((kinds & AMD_DBGAPI_WAVE_FILTER_STATE) != 0
+          && state != filter->state)
+        return false;
+
+      if ((kinds & AMD_DBGAPI_WAVE_FILTER_STOP_REASON) != 0)
+        {
+          if (state != AMD_DBGAPI_WAVE_STATE_STOP)
+            return false;
+
+          if (filter->stop_reasons == AMD_DBGAPI_WAVE_STOP_REASON_NONE
+                ? wave.stop_reason () != AMD_DBGAPI_WAVE_STOP_REASON_NONE
+                : !(wave.stop_reason () & filter->stop_reasons))
+            return false;
+        }
+
+      if ((kinds & AMD_DBGAPI_WAVE_FILTER_PC_RANGE) != 0
+          && (state != AMD_DBGAPI_WAVE_STATE_STOP
+              || wave.pc () < filter->pc_begin
+              || wave.pc () >= filter->pc_end))
+        return false;
+
+      if ((kinds & AMD_DBGAPI_WAVE_FILTER_QUEUE) != 0
+          && wave.queue ().id () != filter->queue_id)
+        return false;
+
+      if ((kinds & AMD_DBGAPI_WAVE_FILTER_DISPATCH) != 0
+          && wave.dispatch ().id () != filter->dispatch_id)
+        return false;
+
+      if ((kinds & AMD_DBGAPI_WAVE_FILTER_AGENT) != 0
+          && wave.agent ().id () != filter->agent_id)
+        return false;
+
+      return true;
+    };
+
+    auto queues_needing_resume = utils::suspend_queues (
+      processes, "filter wave list",
+      [filter, kinds] (const queue_t &queue)
+      {
+        return (kinds & AMD_DBGAPI_WAVE_FILTER_QUEUE) == 0
+               || queue.id () == filter->queue_id;
+      });
+
+    std::vector<amd_dbgapi_wave_id_t> matching_waves;
+    for (auto &&process : processes)
+      for (auto &&wave : process->range<wave_t> ())
+        if (wave.is_valid () && matches (wave))
+          matching_waves.emplace_back (wave.id ());
+
+    auto wave_list = allocate_memory<amd_dbgapi_wave_id_t[]> (
+      matching_waves.size () * sizeof (amd_dbgapi_wave_id_t));
+    std::copy (matching_waves.begin (), matching_waves.end (),
+               wave_list.get ());
+
+    utils::resume_queues (queues_needing_resume, "filter wave list");
+
+    *waves = wave_list.release ();
+    *wave_count = matching_waves.size ();
+  }
+  CATCH (AMD_DBGAPI_STATUS_ERROR_NOT_INITIALIZED,
+         AMD_DBGAPI_STATUS_ERROR_INVALID_PROCESS_ID,
+         AMD_DBGAPI_STATUS_ERROR_INVALID_ARGUMENT,
+         AMD_DBGAPI_STATUS_ERROR_CLIENT_CALLBACK);
+  TRACE_END (make_ref (param_out (wave_count)),
+             make_ref (make_ref (param_out (waves)), *wave_count));
+}
+
+amd_dbgapi_status_t AMD_DBGAPI
+amd_dbgapi_process_wave_summary (amd_dbgapi_process_id_t process_id,
+                                 size_t *summary_count,
+                                 amd_dbgapi_wave_summary_t **summaries)
+{
+  TRACE_BEGIN (param_in (process_id), param_in (summary_count),
+               param_in (summaries));
+  TRY
+  {
+    if (!detail::is_initialized)
+      THROW (AMD_DBGAPI_STATUS_ERROR_NOT_INITIALIZED);
+
+    std::vector<process_t *> processes = process_t::match (process_id);
+
+    if (summary_count == nullptr || summaries == nullptr)
+      THROW (AMD_DBGAPI_STATUS_ERROR_INVALID_ARGUMENT);
+
+    auto queues_needing_resume
+      = utils::suspend_queues (processes, "summarize waves");
+
+    /* Count the waves in a single pass, grouped by queue, state, and stop
+       reason.  */
+    std::map<std::tuple<decltype (amd_dbgapi_queue_id_t::handle),
+                        amd_dbgapi_wave_state_t,
+                        amd_dbgapi_wave_stop_reasons_t>,
+             size_t>
+      groups;
+
+    for (auto &&process : processes)
+      for (auto &&wave : process->range<wave_t> ())
+        {
+          if (!wave.is_valid ())
+            continue;
+
+          const amd_dbgapi_wave_state_t state = wave.client_visible_state ();
+          ++groups[{ wave.queue ().id ().handle, state,
+                     state == AMD_DBGAPI_WAVE_STATE_STOP
+                       ? wave.stop_reason ()
+                       : AMD_DBGAPI_WAVE_STOP_REASON_NONE }];
+        }
+
+    auto summary_list = allocate_memory<amd_dbgapi_wave_summary_t[]> (
+      groups.size () * sizeof (amd_dbgapi_wave_summary_t));
+
+    size_t pos{ 0 };
+    for (auto &&[group, count] : groups)
+      {
+        auto [queue_handle, state, stop_reason] = group;
+        summary_list[pos++]
+          = { amd_dbgapi_queue_id_t{ queue_handle }, state, stop_reason,
+              count };
+      }
+
+    utils::resume_queues (queues_needing_resume, "summarize waves");
+
+    *summaries = summary_list.release ();
+    *summary_count = groups.size ();
+  }
+  CATCH (AMD_DBGAPI_STATUS_ERROR_NOT_INITIALIZED,
+         AMD_DBGAPI_STATUS_ERROR_INVALID_PROCESS_ID,
+         AMD_DBGAPI_STATUS_ERROR_INVALID_ARGUMENT,
+         AMD_DBGAPI_STATUS_ERROR_CLIENT_CALLBACK);
+  TRACE_END (make_ref (param_out (summary_count)),
+             make_ref (make_ref (param_out (summaries)), *summary_count));
+}
+
+amd_dbgapi_status_t AMD_DBGAPI
+amd_dbgapi_wave_get_info_bulk (size_t wave_count,
+                               const amd_dbgapi_wave_id_t *waves,
+                               size_t query_count,
+                               const amd_dbgapi_wave_info_t *queries,
+                               const size_t *value_sizes, void *const *values,
+                               amd_dbgapi_status_t *wave_statuses)
+{
+  TRACE_BEGIN (param_in (wave_count), make_ref (param_in (waves), wave_count),
+               param_in (query_count),
+               make_ref (param_in (queries), query_count),
+               make_ref (param_in (value_sizes), query_count),
+               param_in (values), param_in (wave_statuses));
+  TRY
+  {
+    if (!detail::is_initialized)
+      THROW (AMD_DBGAPI_STATUS_ERROR_NOT_INITIALIZED);
+
+    if ((wave_count != 0 && (waves == nullptr || wave_statuses == nullptr))
+        || (query_count != 0
+            && (queries == nullptr || value_sizes == nullptr
+                || values == nullptr)))
+      THROW (AMD_DBGAPI_STATUS_ERROR_INVALID_ARGUMENT);
+
+    /* Validate all the queries before querying any wave so that the values
+       are left unaltered if a query is invalid.  */
+    bool needs_registers{ false };
+    for (size_t i = 0; i < query_count; ++i)
+      {
+        size_t expected_size;
+        switch (queries[i])
+          {
+          case AMD_DBGAPI_WAVE_INFO_STATE:
+            expected_size = sizeof (amd_dbgapi_wave_state_t);
+            break;
+          case AMD_DBGAPI_WAVE_INFO_STOP_REASON:
+            expected_size = sizeof (amd_dbgapi_wave_stop_reasons_t);
+            break;
+          case AMD_DBGAPI_WAVE_INFO_WORKGROUP:
+            expected_size = sizeof (amd_dbgapi_workgroup_id_t);
+            break;
+          case AMD_DBGAPI_WAVE_INFO_DISPATCH:
+            expected_size = sizeof (amd_dbgapi_dispatch_id_t);
+            break;
+          case AMD_DBGAPI_WAVE_INFO_QUEUE:
+            expected_size = sizeof (amd_dbgapi_queue_id_t);
+            break;
+          case AMD_DBGAPI_WAVE_INFO_AGENT:
+            expected_size = sizeof (amd_dbgapi_agent_id_t);
+            break;
+          case AMD_DBGAPI_WAVE_INFO_PROCESS:
+            expected_size = sizeof (amd_dbgapi_process_id_t);
+            break;
+          case AMD_DBGAPI_WAVE_INFO_ARCHITECTURE:
+            expected_size = sizeof (amd_dbgapi_architecture_id_t);
+            break;
+          case AMD_DBGAPI_WAVE_INFO_PC:
+            expected_size = sizeof (amd_dbgapi_global_address_t);
+            needs_registers = true;
+            break;
+          case AMD_DBGAPI_WAVE_INFO_EXEC_MASK:
+            expected_size = sizeof (uint64_t);
+            needs_registers = true;
+            break;
+          case AMD_DBGAPI_WAVE_INFO_WORKGROUP_COORD:
+            expected_size = sizeof (uint32_t[3]);
+            break;
+          case AMD_DBGAPI_WAVE_INFO_WAVE_NUMBER_IN_WORKGROUP:
+            expected_size = sizeof (uint32_t);
+            break;
+          case AMD_DBGAPI_WAVE_INFO_LANE_COUNT:
+            expected_size = sizeof (size_t);
+            break;
+          default:
+            /* AMD_DBGAPI_WAVE_INFO_WATCHPOINTS allocates memory for each wave
+               and is not supported by the bulk query.  */
+            THROW (AMD_DBGAPI_STATUS_ERROR_INVALID_ARGUMENT);
+          }
+
+        if (values[i] == nullptr)
+          THROW (AMD_DBGAPI_STATUS_ERROR_INVALID_ARGUMENT);
+
+        if (value_sizes[i] != expected_size)
+          THROW (AMD_DBGAPI_STATUS_ERROR_INVALID_ARGUMENT_COMPATIBILITY);
+      }
+
+    /* Suspend the queues of all the waves at once, so that each queue is
+       suspended at most once, instead of once per register read.  */
+    utils::process_queues_t queues_needing_resume;
+    auto resume_queues = utils::make_scope_exit (
+      [&queues_needing_resume] ()
+      { utils::resume_queues (queues_needing_resume, "bulk wave get info"); });
+
+    if (needs_registers)
+      {
+        std::map<process_t *, std::vector<queue_t *>> queues_to_suspend;
+        for (size_t i = 0; i < wave_count; ++i)
+          if (wave_t *wave = find (waves[i]);
+              wave != nullptr && !wave->queue ().is_suspended ())
+            {
+              auto &queues = queues_to_suspend[&wave->process ()];
+              if (std::find (queues.begin (), queues.end (), &wave->queue ())
+                  == queues.end ())
+                queues.emplace_back (&wave->queue ());
+            }
+
+        for (auto &&[process, queues] : queues_to_suspend)
+          {
+            process->suspend_queues (queues, "bulk wave get info");
+
+            if (process->forward_progress_needed ())
+              queues_needing_resume.emplace_back (process, std::move (queues));
+          }
+      }
+
+    /* Suspending the queues may have destroyed some waves, so look them up
+       again.  */
+    std::vector<wave_t *> wave_objects (wave_count);
+    for (size_t i = 0; i < wave_count; ++i)
+      wave_objects[i] = find (waves[i]);
+
+    if (needs_registers)
+      {
+        /* Coalesce the PC and EXEC registers of all the waves into as few
+           memory cache prefetches as possible.  The saved states of waves
+           from the same queue are adjacent in the context save area.  */
+        std::map<process_t *,
+                 std::vector<std::pair<amd_dbgapi_global_address_t,
+                                       amd_dbgapi_global_address_t>>>
+          process_ranges;
+
+        for (auto &&wave : wave_objects)
+          {
+            if (wave == nullptr
+                || wave->client_visible_state () != AMD_DBGAPI_WAVE_STATE_STOP)
+              continue;
+
+            const amdgpu_regnum_t exec_regnum = wave->lane_count () == 32
+                                                  ? amdgpu_regnum_t::exec_32
+                                                  : amdgpu_regnum_t::exec_64;
+
+            for (auto regnum : { amdgpu_regnum_t::pc, exec_regnum })
+              if (auto address = wave->register_address (regnum); address)
+                process_ranges[&wave->process ()].emplace_back (
+                  *address,
+                  *address + wave->architecture ().register_size (regnum));
+          }
+
+        for (auto &&[process, ranges] : process_ranges)
+          {
+            std::sort (ranges.begin (), ranges.end ());
+
+            for (auto it = ranges.begin (); it != ranges.end ();)
+              {
+                auto [begin, end] = *it;
+                for (++it;
+                     it != ranges.end ()
+                     && it->first <= end + memory_cache_t::cache_line_size;
+                     ++it)
+                  end = std::max (end, it->second);
+
+                process->memory_cache ().prefetch (begin, end - begin);
+              }
+          }
+      }
+
+    for (size_t i = 0; i < wave_count; ++i)
+      {
+        wave_t *wave = wave_objects[i];
+
+        if (wave == nullptr)
+          {
+            wave_statuses[i] = AMD_DBGAPI_STATUS_ERROR_INVALID_WAVE_ID;
+            continue;
+          }
+
+        wave_statuses[i] = AMD_DBGAPI_STATUS_SUCCESS;
+        for (size_t j = 0; j < query_count; ++j)
+          {
+            if ((queries[j] == AMD_DBGAPI_WAVE_INFO_STOP_REASON
+                 || queries[j] == AMD_DBGAPI_WAVE_INFO_PC
+                 || queries[j] == AMD_DBGAPI_WAVE_INFO_EXEC_MASK)
+                && wave->client_visible_state () != AMD_DBGAPI_WAVE_STATE_STOP)
+              {
+                wave_statuses[i] = AMD_DBGAPI_STATUS_ERROR_WAVE_NOT_STOPPED;
+                continue;
+              }
+
+            try
+              {
+                wave->get_info (queries[j], value_sizes[j],
+                                static_cast<std::byte *> (values[j])
+                                  + i * value_sizes[j]);
+              }
+            catch (const api_error_t &e)
+              {
+                if (e.code () != AMD_DBGAPI_STATUS_ERROR_NOT_AVAILABLE)
+                  throw;
+                wave_statuses[i] = e.code ();
+              }
+          }
+      }
+  }
+  CATCH (AMD_DBGAPI_STATUS_ERROR_NOT_INITIALIZED,
+         AMD_DBGAPI_STATUS_ERROR_INVALID_ARGUMENT,
+         AMD_DBGAPI_STATUS_ERROR_INVALID_ARGUMENT_COMPATIBILITY,
+         AMD_DBGAPI_STATUS_ERROR_CLIENT_CALLBACK);
+  TRACE_END (make_ref (param_out (wave_statuses), wave_count));
+}
@@ -70,6 +70,10 @@ public:
       | AMD_DBGAPI_WAVE_STOP_REASON_DEBUG_TRAP
       | AMD_DBGAPI_WAVE_STOP_REASON_TRAP;
 
+  /* Maximum number of instructions simulated in a row by wave_t::step before
+     the next instruction is executed by the hardware.  */
+  static constexpr size_t max_simulated_steps = 1024;
+
   enum class visibility_t
   {
     visible,
@@ -87,6 +91,16 @@ public:
   };
 
 private:
+  /* The progress of a wave being stepped over a breakpoint whose condition is
+     false, see wave_t::breakpoint_resume.  */
+  enum class breakpoint_step_t
+  {
+    none,          /* The wave is not stepping over a breakpoint.  */
+    at_breakpoint, /* The wave stopped at the breakpoint.  */
+    stepping,      /* The wave is single-stepping the displaced instruction.  */
+    stepped        /* The wave stepped over the breakpoint.  */
+  };
+
   amd_dbgapi_wave_state_t m_state{ AMD_DBGAPI_WAVE_STATE_RUN };
   bool m_ttmps_initialized{ false };
   bool m_stop_requested{ false };
@@ -97,6 +111,23 @@ private:
   amd_dbgapi_event_id_t m_last_stop_event_id{ AMD_DBGAPI_EVENT_NONE };
   visibility_t m_visibility{ visibility_t::visible };
   bool m_is_parked{ false };
+  /* True if the wave is counted in its agent's memory violation wave count.
+   */
+  bool m_counted_memory_violation{ false };
+  breakpoint_step_t m_breakpoint_step{ breakpoint_step_t::none };
+  /* The action to take for a stop not reported to the client, see
+     process_t::stop_reason_action.  */
+  amd_dbgapi_stop_reason_action_t m_stop_action{
+    AMD_DBGAPI_STOP_REASON_ACTION_REPORT
+  };
+  /* The number of instructions left to step, and the range of pcs the wave
+     is stepped through, see wave_t::step_range.  */
+  amd_dbgapi_size_t m_steps_remaining{ 0 };
+  amd_dbgapi_global_address_t m_step_range_start{ 0 };
+  amd_dbgapi_global_address_t m_step_range_end{ 0 };
+  /* False if the next single-step must be executed by the hardware even if
+     the instruction could be simulated, see wave_t::step.  */
+  bool m_simulate_step{ true };
 
   std::unique_ptr<const architecture_t::cwsr_record_t> m_cwsr_record{};
 
@@ -110,11 +141,32 @@ private:
                        amd_dbgapi_lane_id_t lane_id, void *read,
                        const void *write, size_t size);
 
+  /* Read SIZE bytes of ADDRESS_SPACE starting at SEGMENT_ADDRESS for each
+     lane of LANES into the lane's buffer.  Return the smallest number of
+     bytes read for a lane.  */
+  [[nodiscard]] size_t read_private_swizzled_memory (
+    const private_swizzled_address_space_t &address_space,
+    amd_dbgapi_segment_address_t segment_address,
+    const std::vector<std::pair<amd_dbgapi_lane_id_t, void *>> &lanes,
+    size_t size);
+
   void raise_event (amd_dbgapi_event_kind_t event_kind);
 
   void park ();
   void unpark ();
 
+  /* Return true if the wave stopped at a breakpoint that has a condition, and
+     the condition is false for this wave.  */
+  bool is_breakpoint_condition_false ();
+
+  /* Add or remove this wave from its agent's count of waves stopped with a
+     memory violation, following the wave's state and stop reason.  */
+  void update_memory_violation_count ();
+
+  /* Return the agent of this wave that keeps the count above.  The queue
+     only holds its agent as const, so the agent is found in the process.  */
+  agent_t &counting_agent ();
+
 public:
   wave_t (amd_dbgapi_wave_id_t wave_id, workgroup_t &workgroup,
           std::optional<uint32_t> wave_in_group);
@@ -157,6 +209,44 @@ public:
     return m_displaced_stepping;
   }
 
+  /* Return true if the wave stopped at a breakpoint whose condition is false,
+     or stepped over such a breakpoint, and must be resumed without being
+     reported to the client.  */
+  bool needs_breakpoint_resume () const
+  {
+    return m_breakpoint_step == breakpoint_step_t::at_breakpoint
+           || m_breakpoint_step == breakpoint_step_t::stepped;
+  }
+  /* Step the wave over the breakpoint it stopped at using a displaced
+     stepping buffer, and resume it.  */
+  void breakpoint_resume ();
+
+  /* Return true if the wave stopped for stop reasons that are not reported
+     to the client, and must be resumed or terminated.  */
+  bool needs_stop_action () const
+  {
+    return m_stop_action != AMD_DBGAPI_STOP_REASON_ACTION_REPORT;
+  }
+  /* Resume or terminate the wave according to the action set for its stop
+     reasons.  */
+  void apply_stop_action ();
+
+  /* Single-step the wave until it has executed STEP_COUNT instructions, or
+     its pc is outside [RANGE_START, RANGE_END).  Only the last step is
+     reported to the client.  */
+  void step_range (amd_dbgapi_global_address_t range_start,
+                   amd_dbgapi_global_address_t range_end,
+                   amd_dbgapi_size_t step_count);
+  /* Return true if the wave completed a step of step_range, and must be
+     stepped again.  */
+  bool needs_step () const
+  {
+    return m_state == AMD_DBGAPI_WAVE_STATE_STOP && m_steps_remaining != 0;
+  }
+  /* Single-step the wave, simulating the instructions that can be simulated
+     until the wave has to be resumed or its steps are complete.  */
+  void step ();
+
   /* Update the wave's status from its saved state in the context save area. */
   void
   update (std::unique_ptr<const architecture_t::cwsr_record_t> cwsr_record);
@@ -196,6 +286,18 @@ public:
   void write_register (amdgpu_regnum_t regnum, size_t offset,
                        size_t value_size, const void *value) const;
 
+  /* Read LANE_ID's slice of each of the vector registers REGNUMS into VALUE.
+     The slices are packed in the order of REGNUMS.  */
+  void read_register_lane (amd_dbgapi_lane_id_t lane_id,
+                           const std::vector<amdgpu_regnum_t> &regnums,
+                           void *value) const;
+
+  /* Write LANE_ID's slice of each of the vector registers REGNUMS from VALUE.
+     The slices are packed in the order of REGNUMS.  */
+  void write_register_lane (amd_dbgapi_lane_id_t lane_id,
+                            const std::vector<amdgpu_regnum_t> &regnums,
+                            const void *value) const;
+
   template <typename T, /* T is a pointer or an array.  */
             std::enable_if_t<std::is_pointer_v<std::decay_t<T>>, int> = 0>
   void read_register (amdgpu_regnum_t regnum, T &&value) const
@@ -238,6 +340,14 @@ public:
                        amd_dbgapi_lane_id_t lane_id, void *read,
                        const void *write, size_t size);
 
+  /* Read SIZE bytes of ADDRESS_SPACE starting at SEGMENT_ADDRESS for each
+     lane of LANE_MASK into READ + lane_id * SIZE.  Return the number of bytes
+     read for every lane.  */
+  [[nodiscard]] size_t
+  read_segment_memory_lanes (const address_space_t &address_space,
+                             amd_dbgapi_segment_address_t segment_address,
+                             uint64_t lane_mask, void *read, size_t size);
+
   void get_info (amd_dbgapi_wave_info_t query, size_t value_size,
                  void *value) const;
 
@@ -25,6 +25,12 @@
 #include "process.h"
 #include "queue.h"
 
+#include <algorithm>
+#include <cstring>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
 namespace amd::dbgapi
 {
 
@@ -59,9 +65,10 @@ workgroup_t::update (amd_dbgapi_global_address_t local_memory_base_address)
 }
 
 size_t
-workgroup_t::xfer_local_memory (const address_space_t &address_space,
-                                amd_dbgapi_segment_address_t segment_address,
-                                void *read, const void *write, size_t size)
+workgroup_t::xfer_local_memory (
+  [[maybe_unused]] const address_space_t &address_space,
+  amd_dbgapi_segment_address_t segment_address, void *read, const void *write,
+  size_t size)
 {
   /* The LDS is stored in the context save area.  */
   std::optional<scoped_queue_suspend_t> suspend;
@@ -88,13 +95,10 @@ workgroup_t::xfer_local_memory (const address_space_t &address_space,
   amd_dbgapi_size_t limit = m_local_memory_size;
   amd_dbgapi_size_t offset = segment_address;
 
+  /* Accesses past the end of the LDS are truncated, and return 0 if no bytes
+     are accessible.  */
   if ((offset + size) > limit)
-    {
-      size_t max_size = offset < limit ? limit - offset : 0;
-      if (max_size == 0 && size != 0)
-        throw memory_access_error_t (address_space, limit);
-      size = max_size;
-    }
+    size = offset < limit ? limit - offset : 0;
 
   amd_dbgapi_global_address_t global_address
     = *m_local_memory_base_address + offset;
@@ -207,23 +211,8 @@ amd_dbgapi_process_workgroup_list (amd_dbgapi_process_id_t process_id,
     if (workgroups == nullptr || workgroup_count == nullptr)
       THROW (AMD_DBGAPI_STATUS_ERROR_INVALID_ARGUMENT);
 
-    std::vector<std::pair<process_t *, std::vector<queue_t *>>>
-      queues_needing_resume;
-
-    for (auto &&process : processes)
-      {
-        process->update_queues ();
-
-        std::vector<queue_t *> queues;
-        for (auto &&queue : process->range<queue_t> ())
-          if (!queue.is_suspended ())
-            queues.emplace_back (&queue);
-
-        process->suspend_queues (queues, "refresh workgroup list");
-
-        if (process->forward_progress_needed ())
-          queues_needing_resume.emplace_back (process, std::move (queues));
-      }
+    auto queues_needing_resume
+      = utils::suspend_queues (processes, "refresh workgroup list");
 
     amd_dbgapi_changed_t workgroup_list_changed;
     auto workgroup_list = utils::get_handle_list<workgroup_t> (
@@ -232,8 +221,7 @@ amd_dbgapi_process_workgroup_list (amd_dbgapi_process_id_t process_id,
     auto deallocate_workgroup_list = utils::make_scope_fail (
       [&] () { amd::dbgapi::deallocate_memory (workgroups); });
 
-    for (auto &&[process, queues] : queues_needing_resume)
-      process->resume_queues (queues, "refresh workgroup list");
+    utils::resume_queues (queues_needing_resume, "refresh workgroup list");
 
     std::tie (*workgroups, *workgroup_count) = workgroup_list;
     if (changed != nullptr)
@@ -247,3 +235,237 @@ amd_dbgapi_process_workgroup_list (amd_dbgapi_process_id_t process_id,
              make_ref (make_ref (param_out (workgroups)), *workgroup_count),
              make_ref (param_out (changed)));
 }
+
+amd_dbgapi_status_t AMD_DBGAPI
+amd_dbgapi_process_workgroup_list_delta (
+  amd_dbgapi_process_id_t process_id, amd_dbgapi_list_cursor_t *cursor,
+  amd_dbgapi_list_delta_t *delta_kind, size_t *added_count,
+  amd_dbgapi_workgroup_id_t **added, size_t *removed_count,
+  amd_dbgapi_workgroup_id_t **removed)
+{
+  TRACE_BEGIN (param_in (process_id), param_in (cursor),
+               param_in (delta_kind), param_in (added_count),
+               param_in (added), param_in (removed_count),
+               param_in (removed));
+  TRY
+  {
+    if (!detail::is_initialized)
+      THROW (AMD_DBGAPI_STATUS_ERROR_NOT_INITIALIZED);
+
+    std::vector<process_t *> processes = process_t::match (process_id);
+
+    if (cursor == nullptr || delta_kind == nullptr || added == nullptr
+        || added_count == nullptr || removed == nullptr
+        || removed_count == nullptr)
+      THROW (AMD_DBGAPI_STATUS_ERROR_INVALID_ARGUMENT);
+
+    auto queues_needing_resume
+      = utils::suspend_queues (processes, "refresh workgroup list");
+
+    amd_dbgapi_list_cursor_t workgroup_list_cursor = *cursor;
+    amd_dbgapi_list_delta_t workgroup_list_delta_kind;
+    auto [added_list, added_list_count, removed_list, removed_list_count]
+      = utils::get_handle_list_delta<workgroup_t> (
+        processes, &workgroup_list_cursor, &workgroup_list_delta_kind);
+
+    auto deallocate_workgroup_lists = utils::make_scope_fail (
+      [added_list = added_list, removed_list = removed_list] ()
+      {
+        amd::dbgapi::deallocate_memory (added_list);
+        amd::dbgapi::deallocate_memory (removed_list);
+      });
+
+    utils::resume_queues (queues_needing_resume, "refresh workgroup list");
+
+    *cursor = workgroup_list_cursor;
+    *delta_kind = workgroup_list_delta_kind;
+    *added = added_list;
+    *added_count = added_list_count;
+    *removed = removed_list;
+    *removed_count = removed_list_count;
+  }
+  CATCH (AMD_DBGAPI_STATUS_ERROR_NOT_INITIALIZED,
+         AMD_DBGAPI_STATUS_ERROR_INVALID_PROCESS_ID,
+         AMD_DBGAPI_STATUS_ERROR_INVALID_ARGUMENT,
+         AMD_DBGAPI_STATUS_ERROR_CLIENT_CALLBACK);
+  TRACE_END (make_ref (param_out (cursor)), make_ref (param_out (delta_kind)),
+             make_ref (param_out (added_count)),
+             make_ref (make_ref (param_out (added)), *added_count),
+             make_ref (param_out (removed_count)),
+             make_ref (make_ref (param_out (removed)), *removed_count));
+}
+
+amd_dbgapi_status_t AMD_DBGAPI
+amd_dbgapi_workgroup_local_memory_snapshot (
+  size_t workgroup_count, const amd_dbgapi_workgroup_id_t *workgroups,
+  amd_dbgapi_local_memory_snapshot_kind_t kind, size_t *range_count,
+  amd_dbgapi_local_memory_range_t **ranges, amd_dbgapi_size_t *bytes_size,
+  void **bytes)
+{
+  TRACE_BEGIN (param_in (workgroup_count),
+               make_ref (param_in (workgroups), workgroup_count),
+               param_in (kind), param_in (range_count), param_in (ranges),
+               param_in (bytes_size), param_in (bytes));
+  TRY
+  {
+    /* Cache lines of the context save areas that are not part of the local
+       memory of the requested workgroups, but are read anyway to read the
+       local memory of neighbouring workgroups with a single memory
+       access.  */
+    constexpr amd_dbgapi_size_t local_memory_max_gap = 4096;
+
+    if (!detail::is_initialized)
+      THROW (AMD_DBGAPI_STATUS_ERROR_NOT_INITIALIZED);
+
+    if (workgroups == nullptr || !workgroup_count || range_count == nullptr
+        || ranges == nullptr || bytes_size == nullptr || bytes == nullptr)
+      THROW (AMD_DBGAPI_STATUS_ERROR_INVALID_ARGUMENT);
+
+    if (kind != AMD_DBGAPI_LOCAL_MEMORY_SNAPSHOT_FULL
+        && kind != AMD_DBGAPI_LOCAL_MEMORY_SNAPSHOT_DIFF)
+      THROW (AMD_DBGAPI_STATUS_ERROR_INVALID_ARGUMENT);
+
+    /* The local memory is stored in the context save area, suspend all the
+       queues of the workgroups once.  */
+    std::unordered_map<process_t *, std::vector<queue_t *>> suspended_queues;
+    for (size_t i = 0; i < workgroup_count; ++i)
+      {
+        workgroup_t *workgroup = find (workgroups[i]);
+
+        if (workgroup == nullptr)
+          THROW (AMD_DBGAPI_STATUS_ERROR_INVALID_WORKGROUP_ID);
+
+        queue_t &queue = workgroup->queue ();
+        if (queue.is_suspended ())
+          continue;
+
+        auto &queues = suspended_queues[&workgroup->process ()];
+        if (std::find (queues.begin (), queues.end (), &queue)
+            == queues.end ())
+          queues.emplace_back (&queue);
+      }
+
+    for (auto &&[process, queues] : suspended_queues)
+      process->suspend_queues (queues, "local memory snapshot");
+
+    auto resume_queues = utils::make_scope_exit (
+      [&suspended_queues] ()
+      {
+        for (auto &&[process, queues] : suspended_queues)
+          if (process->forward_progress_needed ())
+            process->resume_queues (queues, "local memory snapshot");
+      });
+
+    /* Look for the workgroups again, all their waves may have exited, and
+       the workgroups may have been destroyed by the queue suspend.  Group
+       the local memory regions by queue.  */
+    std::vector<workgroup_t *> snapshot_workgroups;
+    snapshot_workgroups.reserve (workgroup_count);
+    std::unordered_map<
+      queue_t *,
+      std::vector<std::pair<amd_dbgapi_global_address_t, amd_dbgapi_size_t>>>
+      queue_regions;
+
+    for (size_t i = 0; i < workgroup_count; ++i)
+      {
+        workgroup_t *workgroup = find (workgroups[i]);
+
+        if (workgroup == nullptr)
+          THROW (AMD_DBGAPI_STATUS_ERROR_INVALID_WORKGROUP_ID);
+
+        dbgapi_assert (workgroup->local_memory_address ());
+        snapshot_workgroups.emplace_back (workgroup);
+
+        if (workgroup->local_memory_size ())
+          queue_regions[&workgroup->queue ()].emplace_back (
+            *workgroup->local_memory_address (),
+            workgroup->local_memory_size ());
+      }
+
+    /* Read the local memory of all the workgroups of a queue with as few
+       memory accesses as possible.  */
+    for (auto &&[queue, regions] : queue_regions)
+      queue->process ().memory_cache ().prefetch (std::move (regions),
+                                                  local_memory_max_gap);
+
+    std::vector<amd_dbgapi_local_memory_range_t> range_list;
+    std::vector<std::byte> byte_list;
+    std::vector<std::vector<std::byte>> snapshots;
+    snapshots.reserve (snapshot_workgroups.size ());
+
+    for (auto *workgroup : snapshot_workgroups)
+      {
+        std::vector<std::byte> &snapshot = snapshots.emplace_back (
+          workgroup->local_memory_size ());
+
+        workgroup->process ().read_global_memory (
+          *workgroup->local_memory_address (), snapshot.data (),
+          snapshot.size ());
+
+        auto add_range = [&] (amd_dbgapi_size_t offset, amd_dbgapi_size_t size)
+        {
+          range_list.push_back ({ workgroup->id (), offset, size,
+                                  byte_list.size () });
+          byte_list.insert (byte_list.end (), snapshot.begin () + offset,
+                            snapshot.begin () + offset + size);
+        };
+
+        /* The previous snapshot is only replaced once the result is
+           returned to the client.  */
+        const std::vector<std::byte> &previous
+          = workgroup->local_memory_snapshot ();
+
+        if (kind == AMD_DBGAPI_LOCAL_MEMORY_SNAPSHOT_FULL
+            || previous.size () != snapshot.size ())
+          {
+            if (!snapshot.empty ())
+              add_range (0, snapshot.size ());
+            continue;
+          }
+
+        /* Return the runs of bytes that differ from the previous
+           snapshot.  */
+        for (auto it = snapshot.begin (); it != snapshot.end ();)
+          {
+            auto first = std::mismatch (it, snapshot.end (),
+                                        previous.begin ()
+                                          + (it - snapshot.begin ()))
+                           .first;
+            if (first == snapshot.end ())
+              break;
+
+            auto last = first;
+            while (last != snapshot.end ()
+                   && *last != previous[last - snapshot.begin ()])
+              ++last;
+
+            add_range (first - snapshot.begin (), last - first);
+            it = last;
+          }
+      }
+
+    auto range_array = allocate_memory<amd_dbgapi_local_memory_range_t[]> (
+      range_list.size () * sizeof (amd_dbgapi_local_memory_range_t));
+    auto byte_array = allocate_memory<std::byte[]> (byte_list.size ());
+
+    std::copy (range_list.begin (), range_list.end (), range_array.get ());
+    std::copy (byte_list.begin (), byte_list.end (), byte_array.get ());
+
+    for (size_t i = 0; i < snapshot_workgroups.size (); ++i)
+      snapshot_workgroups[i]->set_local_memory_snapshot (
+        std::move (snapshots[i]));
+
+    *range_count = range_list.size ();
+    *ranges = range_array.release ();
+    *bytes_size = byte_list.size ();
+    *bytes = byte_array.release ();
+  }
+  CATCH (AMD_DBGAPI_STATUS_ERROR_NOT_INITIALIZED,
+         AMD_DBGAPI_STATUS_ERROR_INVALID_WORKGROUP_ID,
+         AMD_DBGAPI_STATUS_ERROR_INVALID_ARGUMENT,
+         AMD_DBGAPI_STATUS_ERROR_MEMORY_ACCESS,
+         AMD_DBGAPI_STATUS_ERROR_CLIENT_CALLBACK);
+  TRACE_END (make_ref (param_out (range_count)),
+             make_ref (make_ref (param_out (ranges)), *range_count),
+             make_ref (param_out (bytes_size)));
+}
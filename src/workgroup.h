@@ -24,7 +24,10 @@
 #include "amd-dbgapi.h"
 #include "handle_object.h"
 
+#include <cstddef>
 #include <optional>
+#include <utility>
+#include <vector>
 
 namespace amd::dbgapi
 {
@@ -47,6 +50,9 @@ private:
   std::optional<amd_dbgapi_global_address_t> m_local_memory_base_address;
   amd_dbgapi_size_t const m_local_memory_size;
 
+  /* Content of the local memory at the last local memory snapshot.  */
+  std::vector<std::byte> m_local_memory_snapshot{};
+
   const dispatch_t &m_dispatch;
 
   [[nodiscard]] size_t
@@ -71,6 +77,21 @@ public:
 
   void update (amd_dbgapi_global_address_t local_memory_base_address);
 
+  std::optional<amd_dbgapi_global_address_t> local_memory_address () const
+  {
+    return m_local_memory_base_address;
+  }
+  amd_dbgapi_size_t local_memory_size () const { return m_local_memory_size; }
+
+  const std::vector<std::byte> &local_memory_snapshot () const
+  {
+    return m_local_memory_snapshot;
+  }
+  void set_local_memory_snapshot (std::vector<std::byte> snapshot)
+  {
+    m_local_memory_snapshot = std::move (snapshot);
+  }
+
   [[nodiscard]] size_t
   xfer_segment_memory (const address_space_t &address_space,
                        amd_dbgapi_segment_address_t segment_address,